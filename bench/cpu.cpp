@@ -0,0 +1,137 @@
+#include "core/CPU.hpp"
+#include "core/hardware.hpp"
+#include "core/InterruptVector.hpp"
+#include "memory/DMAController.hpp"
+#include "memory/MemoryMap.hpp"
+#include "memory/mapping/ArrayMemoryMapping.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+/** CPU benchmark
+Times the CPU coroutine alone, resumed once per CPU cycle like the main loop does, without the PPU, the APU or the main loop itself,
+so that only the instruction decoding and execution are measured. The program is a fixed mix of loads, stores, ALU and CB-prefixed operations,
+conditional jumps, calls, returns and stack operations over random data in WRAM, with a loop counter in HRAM.
+Usage : build/bench/cpu [CPU cycles] (see build.py --bench) */
+
+#define DEFAULT_CYCLES 100000000
+
+// Where the program starts, as with a cartridge without boot ROM
+#define PROGRAM_START 0x0100
+#define SUBROUTINE_START 0x0140
+
+
+using namespace toygb;
+
+// Main program at 0x0100
+static const uint8_t s_program[] = {
+	0x31, 0xFE, 0xFF,  // 0100 : ld sp, $FFFE
+	0xAF,              // 0103 : xor a
+	0xE0, 0x80,        // 0104 : ldh ($80), a       Outer loop counter
+	0xE0, 0x81,        // 0106 : ldh ($81), a
+	0x21, 0x00, 0xC0,  // 0108 : ld hl, $C000       Outer loop
+	0x06, 0x40,        // 010B : ld b, 64
+	0x2A,              // 010D : ld a, (hl+)        Inner loop
+	0x81,              // 010E : add a, c
+	0xAA,              // 010F : xor d
+	0x5F,              // 0110 : ld e, a
+	0xCB, 0x33,        // 0111 : swap e
+	0xCB, 0x5B,        // 0113 : bit 3, e
+	0x28, 0x01,        // 0115 : jr z, $0118
+	0x14,              // 0117 : inc d
+	0x77,              // 0118 : ld (hl), a
+	0xCD, 0x40, 0x01,  // 0119 : call $0140
+	0x05,              // 011C : dec b
+	0x20, 0xEE,        // 011D : jr nz, $010D
+	0xF0, 0x80,        // 011F : ldh a, ($80)
+	0xC6, 0x01,        // 0121 : add a, 1
+	0xE0, 0x80,        // 0123 : ldh ($80), a
+	0xF0, 0x81,        // 0125 : ldh a, ($81)
+	0xCE, 0x00,        // 0127 : adc a, 0
+	0xE0, 0x81,        // 0129 : ldh ($81), a
+	0xC3, 0x08, 0x01,  // 012B : jp $0108
+};
+
+// Subroutine at 0x0140
+static const uint8_t s_subroutine[] = {
+	0xC5,              // 0140 : push bc
+	0x4F,              // 0141 : ld c, a
+	0xCB, 0x01,        // 0142 : rlc c
+	0x79,              // 0144 : ld a, c
+	0xE6, 0x0F,        // 0145 : and $0F
+	0xF6, 0x30,        // 0147 : or $30
+	0xFE, 0x35,        // 0149 : cp $35
+	0x30, 0x01,        // 014B : jr nc, $014E
+	0x3C,              // 014D : inc a
+	0xC1,              // 014E : pop bc
+	0xC9,              // 014F : ret
+};
+
+static uint32_t s_random = 12345;
+
+// Simple xorshift generator, so that every run works on the same data
+static uint32_t randomValue() {
+	s_random ^= s_random << 13;
+	s_random ^= s_random >> 17;
+	s_random ^= s_random << 5;
+	return s_random;
+}
+
+int main(int argc, char** argv) {
+	uint64_t cycles = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : DEFAULT_CYCLES);
+
+	HardwareStatus hardware(OperationMode::DMG, ConsoleModel::DMG, SystemRevision::DMG_C);
+	InterruptVector interrupt;
+	interrupt.init();
+	DMAController dma;
+	dma.init(&hardware);
+
+	// Start right at the program without any boot ROM, the messages of the failed boot ROM lookup are left out
+	GameboyConfig config;
+	config.bootrom = "<none>";
+	CPU cpu(config);
+	std::stringstream discarded;
+	std::streambuf* coutBuffer = std::cout.rdbuf(discarded.rdbuf());
+	std::streambuf* cerrBuffer = std::cerr.rdbuf(discarded.rdbuf());
+	cpu.init(&hardware, &interrupt);
+	std::cout.rdbuf(coutBuffer);
+	std::cerr.rdbuf(cerrBuffer);
+
+	uint8_t* rom = new uint8_t[0x8000];
+	std::memset(rom, 0, 0x8000);
+	std::memcpy(rom + PROGRAM_START, s_program, sizeof(s_program));
+	std::memcpy(rom + SUBROUTINE_START, s_subroutine, sizeof(s_subroutine));
+	ArrayMemoryMapping romMapping(rom);
+
+	MemoryMap memory;
+	memory.add(0x0000, 0x7FFF, &romMapping);
+	interrupt.configureMemory(&memory);
+	cpu.configureMemory(&memory);
+	dma.configureMemory(&memory);
+	memory.build();
+	for (int i = 0; i < 0x100; i++)
+		memory.set(0xC000 + i, randomValue());
+
+	GBComponent component = cpu.run(&memory, &dma);
+	auto start = std::chrono::steady_clock::now();
+	for (uint64_t cycle = 0; cycle < cycles; cycle++) {
+		if (!cpu.skip())
+			component.onCycle();
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	// The loop counter gives the same value on every implementation that executes the program correctly
+	int loops = memory.get(0xFF80) | (memory.get(0xFF81) << 8);
+	uint64_t instructions = cpu.instructionCount();
+	std::cout << std::fixed << std::setprecision(2);
+	std::cout << cycles << " CPU cycles, " << instructions << " instructions (outer loop counter " << loops << ") in " << seconds << " s" << std::endl;
+	std::cout << seconds * 1e9 / cycles << " ns per CPU cycle, " << seconds * 1e9 / instructions << " ns per instruction, "
+			  << instructions / seconds / 1e6 << " million instructions per second" << std::endl;
+	delete[] rom;
+	return 0;
+}
@@ -0,0 +1,111 @@
+#include "graphics/LineKernels.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+
+/** Line kernels benchmark
+Times the tile decoding and the line composition / writing kernels (see graphics/LineKernels.cpp) with every kernel set the host CPU supports,
+on random lines with a third of object pixels, and checks that they all give the same results as the portable implementation.
+Usage : build/bench/linekernels [iterations] (see build.py --bench) */
+
+#define DEFAULT_ITERATIONS 2000000
+
+
+using namespace toygb;
+
+static uint32_t s_random = 12345;
+
+// Simple xorshift generator, so that every run works on the same data
+static uint32_t randomValue() {
+	s_random ^= s_random << 13;
+	s_random ^= s_random >> 17;
+	s_random ^= s_random << 5;
+	return s_random;
+}
+
+static const char* kernelSetName(KernelSet set) {
+	switch (set) {
+		case KernelSet::Scalar: return "scalar";
+		case KernelSet::SSE2: return "SSE2";
+		case KernelSet::AVX2: return "AVX2";
+	}
+	return "?";
+}
+
+// Nanoseconds per iteration of the given function
+template <typename Function>
+static double timeIterations(int iterations, Function function) {
+	auto start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++)
+		function(i);
+	return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / iterations;
+}
+
+int main(int argc, char** argv) {
+	int iterations = (argc > 1 ? std::atoi(argv[1]) : DEFAULT_ITERATIONS);
+
+	uint8_t background[LINE_PIXELS], objects[LINE_PIXELS];
+	for (int x = 0; x < LINE_PIXELS; x++) {
+		background[x] = randomValue() & (LAYER_INDEX_MASK | LAYER_PRIORITY);
+		objects[x] = (randomValue() % 3 == 0 ? randomValue() & (LAYER_INDEX_MASK | LAYER_PRIORITY) : 0);
+	}
+	uint32_t colors[LINE_COLORS_SIZE];
+	for (int i = 0; i < LINE_COLORS_SIZE; i++)
+		colors[i] = randomValue();
+	uint8_t tile[16];
+	for (int i = 0; i < 16; i++)
+		tile[i] = randomValue();
+
+	// Reference results from the portable kernels
+	uint8_t referenceIndices[LINE_PIXELS], referenceLine[LINE_PIXELS * 4], referenceNormal[64], referenceFlipped[64];
+	useKernelSet(KernelSet::Scalar);
+	composeLine(background, objects, referenceIndices, true, false);
+	writeLine(referenceIndices, colors, referenceLine, 4);
+	decodeTileRows(tile, referenceNormal, referenceFlipped);
+
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << iterations << " iterations, best kernel set on this CPU : " << kernelSetName(bestKernelSet()) << std::endl;
+	for (KernelSet set : {KernelSet::Scalar, KernelSet::SSE2, KernelSet::AVX2}) {
+		if (int(set) > int(bestKernelSet()))
+			break;
+		useKernelSet(set);
+
+		uint8_t indices[LINE_PIXELS], line[LINE_PIXELS * 4], normal[64], flipped[64];
+		composeLine(background, objects, indices, true, false);
+		writeLine(indices, colors, line, 4);
+		decodeTileRows(tile, normal, flipped);
+		bool identical = std::memcmp(indices, referenceIndices, sizeof(indices)) == 0 && std::memcmp(line, referenceLine, sizeof(line)) == 0 &&
+						 std::memcmp(normal, referenceNormal, sizeof(normal)) == 0 && std::memcmp(flipped, referenceFlipped, sizeof(flipped)) == 0;
+
+		// The compiler barriers keep the calls from being optimized out or hoisted from the loops
+		double compose = timeIterations(iterations, [&](int) {
+			composeLine(background, objects, indices, true, false);
+			asm volatile("" : : "r"(indices) : "memory");
+		});
+		double write32 = timeIterations(iterations, [&](int) {
+			writeLine(indices, colors, line, 4);
+			asm volatile("" : : "r"(line) : "memory");
+		});
+		double write16 = timeIterations(iterations, [&](int) {
+			writeLine(indices, colors, line, 2);
+			asm volatile("" : : "r"(line) : "memory");
+		});
+		uint8_t changingTile[16];
+		std::memcpy(changingTile, tile, sizeof(tile));
+		double decode = timeIterations(iterations, [&](int i) {
+			changingTile[i & 15] ^= i;
+			decodeTileRows(changingTile, normal, flipped);
+			asm volatile("" : : "r"(normal), "r"(flipped) : "memory");
+		});
+
+		std::cout << std::setw(6) << kernelSetName(set) << " : composeLine " << compose << " ns/line, writeLine " << write32 << " ns/line (32 bits) "
+				  << write16 << " ns/line (16 bits), decodeTileRows " << decode << " ns/tile" << (identical ? "" : "  RESULTS DIFFER FROM SCALAR") << std::endl;
+		if (!identical)
+			return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,91 @@
+#include "audio/AudioBuffer.hpp"
+#include "audio/AudioMixer.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+/** Audio mixer benchmark
+Times the band-limited synthesis (see audio/AudioMixer.cpp) with the portable and the SSE2 implementations, on four square waves of different
+frequencies with random volumes, flushed every OUTPUT_UPDATE_PERIOD APU cycles like AudioController::catchUp does, and checks that both give the same samples.
+Usage : build/bench/mixer [seconds of audio] (see build.py --bench) */
+
+#define DEFAULT_SECONDS 60
+
+
+using namespace toygb;
+
+// Simple xorshift generator, so that every run works on the same data
+static uint32_t randomValue(uint32_t& state) {
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+struct MixerRun {
+	double seconds;   // Time taken
+	uint64_t steps;   // Amount of level changes
+	uint64_t hash;    // FNV-1a hash of the output samples
+};
+
+// Synthesize the given amount of audio, and take the samples out of the buffer as an audio output would
+static MixerRun runMixer(int audioSeconds) {
+	AudioBuffer buffer;
+	AudioMixer mixer(&buffer, DMG_CAPACITOR_CHARGE);
+	for (int channel = 0; channel < 4; channel++)
+		mixer.setVolume(channel, 0, 2400, 1800);
+
+	// Periods in APU cycles, from a high-pitched square wave to the typical noise channel rate
+	const uint64_t periods[4] = {37, 53, 211, 9};
+	uint64_t nextChange[4] = {0, 0, 0, 0};
+	float signs[4] = {1, 1, 1, 1};
+	uint32_t random = 12345;
+
+	int16_t samples[2 * OUTPUT_BUFFER_SAMPLES];
+	MixerRun result = {0, 0, 1469598103934665603ULL};
+	uint64_t cycles = uint64_t(APU_CLOCK_FREQUENCY) * audioSeconds;
+	auto start = std::chrono::steady_clock::now();
+	for (uint64_t cycle = 0; cycle < cycles; cycle += OUTPUT_UPDATE_PERIOD) {
+		uint64_t end = cycle + OUTPUT_UPDATE_PERIOD;
+		for (int channel = 0; channel < 4; channel++) {
+			for (; nextChange[channel] < end; nextChange[channel] += periods[channel]) {
+				signs[channel] = -signs[channel];
+				mixer.setLevel(channel, nextChange[channel], signs[channel] * (randomValue(random) & 7) / 7.0f);
+				result.steps++;
+			}
+		}
+		mixer.flush(end);
+
+		while (buffer.available() >= OUTPUT_BUFFER_SAMPLES) {
+			buffer.read(samples, OUTPUT_BUFFER_SAMPLES);
+			for (int i = 0; i < 2 * OUTPUT_BUFFER_SAMPLES; i++) {
+				result.hash ^= uint16_t(samples[i]);
+				result.hash *= 1099511628211ULL;
+			}
+		}
+	}
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	return result;
+}
+
+int main(int argc, char** argv) {
+	int audioSeconds = (argc > 1 ? std::atoi(argv[1]) : DEFAULT_SECONDS);
+
+	AudioMixer::usePortableKernels(true);
+	MixerRun portable = runMixer(audioSeconds);
+	AudioMixer::usePortableKernels(false);
+	MixerRun fastest = runMixer(audioSeconds);
+
+	std::cout << std::fixed << std::setprecision(3);
+	std::cout << audioSeconds << " seconds of audio, " << portable.steps << " level changes" << std::endl;
+	std::cout << "portable : " << portable.seconds << " s, " << std::setprecision(1) << portable.seconds * 1e9 / portable.steps << " ns per change" << std::endl;
+	std::cout << std::setprecision(3) << "fastest  : " << fastest.seconds << " s, " << std::setprecision(1) << fastest.seconds * 1e9 / fastest.steps << " ns per change" << std::endl;
+	if (portable.hash != fastest.hash) {
+		std::cout << "RESULTS DIFFER BETWEEN THE IMPLEMENTATIONS" << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,108 @@
+#include "graphics/LCDController.hpp"
+#include "core/hardware.hpp"
+#include "core/InterruptVector.hpp"
+#include "memory/MemoryMap.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+/** PPU benchmark
+Times the rendering of whole frames by the PPU alone, on random tiles, maps and objects, with the background, the window and 10 objects per line.
+The static scene is rendered one scanline at a time, while the raster scene writes SCX in the middle of every line, so that each line goes through
+the pixel FIFOs from the register write on (see LCDController::waitClocks).
+Usage : build/bench/ppu [frames] (see build.py --bench) */
+
+#define DEFAULT_FRAMES 600
+
+// Clocks per frame and per scanline
+#define FRAME_CLOCKS 70224
+#define LINE_CLOCKS 456
+
+// Clock of each line at which SCX is written in the raster scene, in the middle of mode 3
+#define RASTER_WRITE_CLOCK 200
+
+
+using namespace toygb;
+
+static uint32_t s_random = 12345;
+
+// Simple xorshift generator, so that every run works on the same data
+static uint32_t randomValue() {
+	s_random ^= s_random << 13;
+	s_random ^= s_random >> 17;
+	s_random ^= s_random << 5;
+	return s_random;
+}
+
+// Render the given amount of frames, return the time per frame in microseconds
+static double renderFrames(bool cgb, int frames, bool raster) {
+	HardwareStatus hardware(cgb ? OperationMode::CGB : OperationMode::DMG, cgb ? ConsoleModel::CGB : ConsoleModel::DMG, cgb ? SystemRevision::CGB_E : SystemRevision::DMG_C);
+	hardware.setBootromStatus(true);
+	InterruptVector interrupt;
+	interrupt.init();
+	MemoryMap memory;
+	LCDController lcd;
+	lcd.init(&hardware, &interrupt, PixelFormat::RGBA8888);
+	interrupt.configureMemory(&memory);
+	lcd.configureMemory(&memory);
+	memory.build();
+
+	// Fill VRAM, OAM and the palettes while the LCD is off
+	memory.set(IO_LCD_CONTROL, 0x00);
+	GBComponent component = lcd.run();
+	for (int bank = 0; bank < (cgb ? 2 : 1); bank++) {
+		if (cgb)
+			memory.set(IO_VRAM_BANK, bank);
+		for (int i = 0; i < 0x2000; i++)
+			memory.set(0x8000 + i, randomValue());
+	}
+	if (cgb) {
+		memory.set(IO_VRAM_BANK, 0);
+		memory.set(IO_BGPALETTE_INDEX, 0x80);
+		for (int i = 0; i < 64; i++)
+			memory.set(IO_BGPALETTE_DATA, randomValue());
+		memory.set(IO_OBJPALETTE_INDEX, 0x80);
+		for (int i = 0; i < 64; i++)
+			memory.set(IO_OBJPALETTE_DATA, randomValue());
+	}
+	for (int i = 0; i < 40; i++) {
+		memory.set(0xFE00 + 4*i, 16 + (i * 144 / 40));   // Y : about 10 objects on each line, with 8x16 objects
+		memory.set(0xFE00 + 4*i + 1, 8 + randomValue() % 160);  // X
+		memory.set(0xFE00 + 4*i + 2, randomValue());  // Tile
+		memory.set(0xFE00 + 4*i + 3, randomValue());  // Attributes
+	}
+	memory.set(IO_BG_PALETTE, 0xE4);
+	memory.set(IO_OBJ0_PALETTE, 0xD2);
+	memory.set(IO_OBJ1_PALETTE, 0x1B);
+	memory.set(IO_WINDOW_Y, 40);
+	memory.set(IO_WINDOW_X, 90);
+	memory.set(IO_LCD_CONTROL, 0xF7);  // LCD, window, objects and background on, 8x16 objects
+
+	uint64_t clocks = uint64_t(frames) * FRAME_CLOCKS;
+	auto start = std::chrono::steady_clock::now();
+	for (uint64_t clock = 0; clock < clocks; clock++) {
+		if (raster && clock % LINE_CLOCKS == RASTER_WRITE_CLOCK)
+			memory.set(IO_SCROLL_X, clock / LINE_CLOCKS);
+		if (!lcd.skip())
+			component.onCycle();
+		if (lcd.hasNewFrame())
+			lcd.pixels();
+	}
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / frames;
+}
+
+int main(int argc, char** argv) {
+	int frames = (argc > 1 ? std::atoi(argv[1]) : DEFAULT_FRAMES);
+
+	std::cout << std::fixed << std::setprecision(1);
+	std::cout << frames << " frames, in microseconds per frame (" << 1000000.0 * FRAME_CLOCKS / CLOCK_FREQUENCY << " in real time)" << std::endl;
+	for (bool cgb : {false, true}) {
+		double staticScene = renderFrames(cgb, frames, false);
+		double rasterScene = renderFrames(cgb, frames, true);
+		std::cout << (cgb ? "CGB" : "DMG") << " : static scene " << staticScene << ", SCX written on every line " << rasterScene << std::endl;
+	}
+	return 0;
+}
@@ -101,3 +101,20 @@ if "--bundle" in sys.argv or "--full" in sys.argv:
 	command = f"{CC} -o {EXE} {' '.join(objects)} {LDFLAGS}"
 	print(command)
 	if (os.system(command) != 0): exit(1)
+
+# Microbenchmarks : each file in bench/ is linked with the emulator objects into build/bench/<name>, meant to be used with --release
+if "--bench" in sys.argv:
+	if "--release" not in sys.argv:
+		print("Warning : benchmarks built without --release are not optimized")
+
+	benchdir = os.path.join("build", "bench")
+	if not os.path.exists(benchdir):
+		os.mkdir(benchdir)
+
+	benchobjects = [objpath for objpath in objects if objpath != os.path.join("build", "main.o")]
+	for filename in sorted(os.listdir("bench")):
+		srcpath = os.path.join("bench", filename)
+		buildpath = os.path.join(benchdir, filename.replace(".cpp", ""))
+		command = f"{CC} {CFLAGS} -o {buildpath} {srcpath} {' '.join(benchobjects)} {LDFLAGS}"
+		print(command)
+		if (os.system(command) != 0): exit(1)
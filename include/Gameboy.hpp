@@ -2,11 +2,13 @@
 #define _GAMEBOY_HPP
 
 #include <string>
+#include <algorithm>
 #include <chrono>
 #include <thread>
 
 #include "GameboyConfig.hpp"
 #include "audio/AudioController.hpp"
+#include "audio/AudioFileWriter.hpp"
 #include "cart/CartController.hpp"
 #include "communication/CommunicationController.hpp"
 #include "control/JoypadController.hpp"
@@ -26,6 +28,7 @@ namespace toygb {
 	class Gameboy {
 		public:
 			Gameboy(GameboyConfig& config);
+			~Gameboy();
 			void main();  // Main emulator loop
 
 		private:
@@ -41,7 +44,10 @@ namespace toygb {
 
 			HardwareStatus m_hardware;
 			MemoryMap m_memory;
-			Interface m_interface;
+			Interface* m_interface;  // User interface, nullptr when running headless
+			AudioFileWriter* m_audioWriter;  // Audio file output, nullptr when not rendering audio to a file
+
+			bool isBudgetReached(clocktime_t startTime);  // Tell whether the run limits set in the config have been reached
 	};
 
 	void runInterface(Interface* interface, LCDController* lcd, AudioController* audio, JoypadController* joypad);
@@ -2,6 +2,7 @@
 #define _GAMEBOYCONFIG_HPP
 
 #include <string>
+#include <cstdint>
 
 #include "core/hardware.hpp"
 
@@ -22,6 +23,19 @@ namespace toygb {
 
 			bool disassemble;
 
+			// Run control
+			bool headless;       // Run without any interface (no window nor audio output) and without speed limit
+			bool uncapped;       // Run as fast as possible instead of pacing the emulation to real time
+			bool audioSync;      // Keep the emulation in step with the audio output instead of the system clock alone
+			uint64_t maxFrames;  // Stop after that many frames have been emulated (0 = no limit)
+			uint64_t maxCycles;  // Stop after that many clocks have been emulated (0 = no limit)
+			double maxTime;      // Stop after that many seconds of real time (0 = no limit)
+			int frameSkip;       // Only draw 1 frame out of frameSkip, the others keep their timings but are not drawn (1 = every frame, 0 = only on request)
+			std::string audioFile;  // Write the audio output into that file instead of playing it (WAV if it ends with .wav, raw PCM otherwise, empty = none)
+
+			// Display
+			bool smoothScaling;  // Scale the screen with bilinear filtering instead of nearest-neighbour
+
 			// Default boot ROM files
 			std::string defaultBootDMG0;
 			std::string defaultBootDMG;
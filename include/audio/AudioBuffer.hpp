@@ -0,0 +1,47 @@
+#ifndef _AUDIO_AUDIOBUFFER_HPP
+#define _AUDIO_AUDIOBUFFER_HPP
+
+#include <atomic>
+#include <cstdint>
+
+// Capacity of the buffer between the APU and the audio output, in stereo frames. Must be a power of 2
+#define AUDIO_BUFFER_FRAMES 8192
+
+
+namespace toygb {
+	/** Lock-free single-producer / single-consumer ring buffer of mixed PCM16 stereo frames (left first)
+	 *  The emulation thread pushes the frames as the APU outputs them, and the audio thread reads them, neither of them ever waits for the other */
+	class AudioBuffer {
+		public:
+			AudioBuffer();
+			~AudioBuffer();
+
+			/** Producer side : add `count` interleaved frames at once, the ones that do not fit are dropped and counted as overruns */
+			void push(const int16_t* frames, int count);
+
+			/** Consumer side : fill the given buffer with `count` frames
+			 *  If not enough frames are available, the missing ones repeat the last frame read and an underrun is counted
+			 *  Return the number of frames actually taken from the buffer */
+			int read(int16_t* frames, int count);
+
+			/** Number of frames currently waiting in the buffer, may be called from either side */
+			int available() const;
+
+			uint64_t underruns() const;  // Number of reads that could not be fully satisfied
+			uint64_t overruns() const;   // Number of frames dropped because the buffer was full
+
+		private:
+			int16_t* m_frames;
+			int16_t m_lastFrame[2];  // Last frame read, only used by the consumer
+
+			// Free-running frame indices, the actual position in the buffer is the index modulo AUDIO_BUFFER_FRAMES
+			// Each is only written by one side, and kept on its own cache line so that the two threads do not keep stealing it from each other
+			alignas(64) std::atomic<uint32_t> m_writeIndex;
+			alignas(64) std::atomic<uint32_t> m_readIndex;
+
+			std::atomic<uint64_t> m_underruns;
+			std::atomic<uint64_t> m_overruns;
+	};
+}
+
+#endif
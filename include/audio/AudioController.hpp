@@ -3,6 +3,8 @@
 
 // Reference for almost everything in the audio controller : https://gbdev.gg8.se/wiki/articles/Gameboy_sound_hardware
 
+#include "audio/AudioBuffer.hpp"
+#include "audio/AudioMixer.hpp"
 #include "audio/mapping/AudioChannelMapping.hpp"
 #include "audio/mapping/AudioToneSweepMapping.hpp"
 #include "audio/mapping/AudioToneMapping.hpp"
@@ -11,6 +13,7 @@
 #include "audio/mapping/AudioControlMapping.hpp"
 #include "audio/mapping/AudioDebugMapping.hpp"
 #include "audio/mapping/WaveMemoryMapping.hpp"
+#include "audio/mapping/AudioSyncMapping.hpp"
 #include "core/timing.hpp"
 #include "core/hardware.hpp"
 #include "memory/Constants.hpp"
@@ -19,8 +22,10 @@
 
 
 namespace toygb {
-	/** Main audio controller, emulates the APU */
-	class AudioController {
+	/** Main audio controller, emulates the APU
+	 * The APU is not run on every clock : it only catches up with the emulated time when its state may be observed (register access),
+	 * before the clock state it depends on changes, and periodically to keep the audio output supplied */
+	class AudioController : public LazyComponent {
 		public:
 			AudioController();
 			~AudioController();
@@ -28,16 +33,33 @@ namespace toygb {
 			void configureMemory(MemoryMap* memory);
 			void init(HardwareStatus* hardware);
 
-			/** Main component, called every APU cycle (2MHz, regardless of double-speed mode) */
-			void runCycle();
+			/** Main component, called on every clock that is run, catches up with the emulated time when the audio output needs more samples */
+			void update();
 
-			/** Read the samples for an audio buffer if available
-			 * If the amount of available samples is greater than audio/timing.hpp:OUTPUT_BUFFER_SAMPLES,
-			 * return true and fill the given buffer with the available samples
-			 * Otherwise, return false and clear the buffer.
-			 * The output is the fully mixed PCM16 audio data */
+			/** Tell in how many clocks update() needs to be called at the latest */
+			int nextEvent();
+
+			/** Run all APU cycles (2MHz, regardless of double-speed mode) up to the current clock, excluded */
+			void catchUp();
+
+			/** Apply the current control register values (NR50-NR52) to the channels power and volumes, from the current APU cycle on (called after writes to them) */
+			void updateVolumes();
+
+			/** Apply the current register values to the channel outputs, from the current APU cycle on (called after register writes) */
+			void updateOutputs();
+
+			/** Read the samples for an audio buffer, from the audio output thread
+			 * Fill the given buffer with audio/timing.hpp:OUTPUT_BUFFER_SAMPLES stereo frames of fully mixed PCM16 audio data, left first
+			 * This never blocks : if not enough samples have been generated yet, the end of the buffer holds the last sample, and this returns false */
 			bool getSamples(int16_t* buffer);
 
+			/** Set the output sample rate relative to OUTPUT_SAMPLE_FREQUENCY, to follow the actual pace of the audio output (see Gameboy::main) */
+			void setOutputRate(double factor);
+
+			int bufferedSamples() const;  // Number of stereo frames waiting for the audio output
+			uint64_t underruns() const;   // Number of calls to getSamples() that ran out of samples
+			uint64_t overruns() const;    // Number of samples dropped because the audio output did not take them in time
+
 		private:
 			HardwareStatus* m_hardware;
 
@@ -47,8 +69,14 @@ namespace toygb {
 			AudioControlMapping* m_control;
 			AudioDebugMapping* m_debug;
 			WaveMemoryMapping* m_wavePatternMapping;
+			AudioSyncMapping* m_syncMappings[7];  // Wrappers of all the mappings above, that are actually added to the memory map
+
+			AudioBuffer m_buffer;       // Mixed samples, waiting for the audio output
+			AudioMixer* m_mixer;
 
-			int m_cyclesToSkip;
+			uint64_t m_cycle;            // Next APU cycle to run, APU cycle n runs at timestamp 4n (see HardwareStatus::getTimestamp)
+			uint64_t m_nextUpdate;       // Timestamp at which update() must catch up at the latest
+			uint16_t m_previousDivider;  // Divider value at the last APU cycle that was run, for the frame sequencer
 	};
 }
 
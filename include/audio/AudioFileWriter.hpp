@@ -0,0 +1,63 @@
+#ifndef _AUDIO_AUDIOFILEWRITER_HPP
+#define _AUDIO_AUDIOFILEWRITER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include "audio/AudioBuffer.hpp"
+#include "audio/AudioController.hpp"
+#include "audio/timing.hpp"
+
+// Amount of stereo frames gathered before each write to the file (256 KB)
+#define AUDIO_FILE_BUFFER_FRAMES 65536
+
+// The emulation waits for the writer when less than that many frames are free in the audio buffer, so that none is ever dropped
+// This must cover all samples that may be produced between two calls to AudioFileWriter::throttle, the APU catches up by ~100 at once
+#define AUDIO_FILE_MIN_FREE_FRAMES OUTPUT_BUFFER_SAMPLES
+
+
+namespace toygb {
+	/** Writes the audio output into a file instead of an audio device, for offline rendering
+	 *  The samples are taken from the audio controller and written from a separate thread, as a WAV file if the file name ends with .wav, raw PCM otherwise
+	 *  (signed 16-bits little-endian, stereo interleaved left first, at OUTPUT_SAMPLE_FREQUENCY) */
+	class AudioFileWriter {
+		public:
+			AudioFileWriter(std::string filename, AudioController* controller);  // Throws an EmulationError if the file can not be opened
+			~AudioFileWriter();
+
+			/** Start writing the samples from the writer thread */
+			void start();
+
+			/** Called from the emulation thread, wait until there is enough space in the audio buffer for the samples to come */
+			void throttle();
+
+			/** Write all remaining samples, and close the file. The emulation must have caught up with the APU before (see AudioController::catchUp)
+			 *  Throws an EmulationError if anything could not be written */
+			void stop();
+
+			uint64_t framesWritten() const;
+
+		private:
+			void run();
+			void writeFrames(const int16_t* frames, int count);
+			void flush();
+			void writeHeader();
+
+			std::string m_filename;
+			std::ofstream m_file;
+			bool m_wave;  // Whether to write a WAV header
+
+			AudioController* m_controller;
+			std::thread m_thread;
+			std::atomic<bool> m_running;
+
+			int16_t* m_buffer;          // Frames waiting to be written to the file
+			int m_bufferedFrames;
+			uint64_t m_framesWritten;
+	};
+}
+
+#endif
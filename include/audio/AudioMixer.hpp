@@ -0,0 +1,74 @@
+#ifndef _AUDIO_AUDIOMIXER_HPP
+#define _AUDIO_AUDIOMIXER_HPP
+
+#include <cstdint>
+
+#include "audio/AudioBuffer.hpp"
+#include "audio/timing.hpp"
+
+// Band-limited step kernel : each level change is spread over MIXER_KERNEL_TAPS output samples, with MIXER_KERNEL_PHASES sub-sample positions
+#define MIXER_KERNEL_TAPS 16
+#define MIXER_KERNEL_PHASES 32
+
+// Size of the buffer of pending output samples, must hold the samples of OUTPUT_UPDATE_PERIOD APU cycles plus MIXER_KERNEL_TAPS (see AudioController::catchUp)
+#define MIXER_BUFFER_SAMPLES 512
+
+// Charge factor per clock of the capacitor that filters the DC offset out of the output, on DMG and SGB / on MGB and CGB
+// (https://gbdev.gg8.se/wiki/articles/Gameboy_sound_hardware)
+#define DMG_CAPACITOR_CHARGE 0.999958
+#define CGB_CAPACITOR_CHARGE 0.998943
+
+
+namespace toygb {
+	/** Band-limited synthesis of the APU output
+	 * The channels do not output samples at the output frequency, instead they tell at which APU cycle their output level changes,
+	 * and each change is added as a band-limited step into the output samples. The output samples are computed once all changes that may affect them are known */
+	class AudioMixer {
+		public:
+			/** capacitorCharge is the charge factor of the output high-pass filter per clock (DMG_CAPACITOR_CHARGE or CGB_CAPACITOR_CHARGE) */
+			AudioMixer(AudioBuffer* output, double capacitorCharge);
+			~AudioMixer();
+
+			/** Set the output level of a channel from the given APU cycle on, in range [-1, 1] */
+			void setLevel(int channel, uint64_t cycle, float level);
+
+			/** Set the volume of a channel on the left and right outputs from the given APU cycle on, in output sample units, at most 2400 */
+			void setVolume(int channel, uint64_t cycle, int left, int right);
+
+			/** Set the output sample rate from the given APU cycle on, relative to OUTPUT_SAMPLE_FREQUENCY (1.0 = nominal) */
+			void setRate(uint64_t cycle, double factor);
+
+			/** Send all output samples that are complete at the given APU cycle to the output buffer
+			 * No level or volume change may be set before that cycle afterwards */
+			void flush(uint64_t cycle);
+
+			/** Use the portable implementations instead of the SSE2 ones from now on (for benchmarks), or go back to the fastest ones the host CPU supports */
+			static void usePortableKernels(bool portable);
+
+		private:
+			void updateChannel(int channel, uint64_t cycle);
+			uint64_t position(uint64_t cycle) const;
+
+			AudioBuffer* m_output;
+
+			// Current state of each channel
+			float m_levels[4];
+			int m_volumes[4][2];        // Left and right volumes
+			int m_contributions[4][2];  // Current value of each channel on the left and right outputs, in output sample units
+
+			// Pending output samples, as the differences between consecutive samples (see AudioMixer::addStep), from m_nextSample on
+			int32_t* m_deltas;
+			int16_t* m_samples;         // Completed samples, before they are sent to the output buffer
+			uint64_t m_nextSample;      // Index of the next output sample to complete
+			int32_t m_accumulators[2];  // Left and right output values, in fixed point, at the last completed sample
+			float m_capacitors[2];      // Left and right high-pass filter capacitor voltages
+			float m_charge;             // Capacitor charge factor per output sample
+
+			// Position of APU cycles in the output, in fixed point output samples (see AudioMixer::position)
+			uint64_t m_step;            // Output samples per APU cycle
+			uint64_t m_anchorCycle;     // Last rate change
+			uint64_t m_anchorPosition;  // Position of m_anchorCycle
+	};
+}
+
+#endif
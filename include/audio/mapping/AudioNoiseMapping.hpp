@@ -13,7 +13,7 @@ namespace toygb {
 	/** Noise channel implementation (channel 4) */
 	class AudioNoiseMapping : public AudioChannelMapping {
 		public:
-			AudioNoiseMapping(int channel, AudioControlMapping* control, AudioDebugMapping* debug, HardwareStatus* hardware);
+			AudioNoiseMapping(int channel, AudioControlMapping* control, AudioDebugMapping* debug, AudioMixer* mixer, HardwareStatus* hardware);
 
 			uint8_t get(uint16_t address);
 			void set(uint16_t address, uint8_t value);
@@ -41,7 +41,7 @@ namespace toygb {
 			float buildSample();
 			void onPowerOn();
 			void onPowerOff();
-			void onUpdate();
+			void onUpdate(uint64_t cycle, int cycles);
 			void onLengthFrame();
 			void onEnvelopeFrame();
 
@@ -0,0 +1,30 @@
+#ifndef _AUDIO_MAPPING_AUDIOSYNCMAPPING_HPP
+#define _AUDIO_MAPPING_AUDIOSYNCMAPPING_HPP
+
+#include "memory/MemoryMapping.hpp"
+
+
+namespace toygb {
+	class AudioController;
+
+	/** Wraps an APU memory mapping, to bring the APU up to date before every access from the CPU
+	 * The APU only catches up with the emulated time when it is needed (see AudioController::catchUp), so its registers must not be accessed directly */
+	class AudioSyncMapping : public MemoryMapping {
+		public:
+			/** controlsVolumes tells whether writes to the mapping may change the channels power and volumes (see AudioController::updateVolumes) */
+			AudioSyncMapping(MemoryMapping* mapping, AudioController* controller, bool controlsVolumes = false);
+
+			uint8_t get(uint16_t address);
+			void set(uint16_t address, uint8_t value);
+
+			void load(std::istream& input);
+			void save(std::ostream& output);
+
+		private:
+			MemoryMapping* m_mapping;  // Wrapped mapping, not owned
+			AudioController* m_controller;
+			bool m_controlsVolumes;
+	};
+}
+
+#endif
@@ -13,7 +13,7 @@ namespace toygb {
 	/** Tone (square wave) channel memory mapping and operation (channel 2) */
 	class AudioToneMapping : public AudioChannelMapping {
 		public:
-			AudioToneMapping(int channel, AudioControlMapping* control, AudioDebugMapping* debug, HardwareStatus* hardware);
+			AudioToneMapping(int channel, AudioControlMapping* control, AudioDebugMapping* debug, AudioMixer* mixer, HardwareStatus* hardware);
 
 			uint8_t get(uint16_t address);
 			void set(uint16_t address, uint8_t value);
@@ -40,7 +40,7 @@ namespace toygb {
 			float buildSample();
 			void onPowerOn();
 			void onPowerOff();
-			void onUpdate();
+			void onUpdate(uint64_t cycle, int cycles);
 			void onLengthFrame();
 			void onEnvelopeFrame();
 
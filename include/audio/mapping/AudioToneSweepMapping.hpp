@@ -13,7 +13,7 @@ namespace toygb {
 	/** Tone (square wave) channel with frequency sweep memory mapping and operation (channel 2) */
 	class AudioToneSweepMapping : public AudioChannelMapping {
 		public:
-			AudioToneSweepMapping(int channel, AudioControlMapping* control, AudioDebugMapping* debug, HardwareStatus* hardware);
+			AudioToneSweepMapping(int channel, AudioControlMapping* control, AudioDebugMapping* debug, AudioMixer* mixer, HardwareStatus* hardware);
 
 			uint8_t get(uint16_t address);
 			void set(uint16_t address, uint8_t value);
@@ -46,7 +46,7 @@ namespace toygb {
 			float buildSample();
 			void onPowerOn();
 			void onPowerOff();
-			void onUpdate();
+			void onUpdate(uint64_t cycle, int cycles);
 			void onLengthFrame();
 			void onSweepFrame();
 			void onEnvelopeFrame();
@@ -14,7 +14,7 @@ namespace toygb {
 	/** Custom wave channel memory mapping and operation */
 	class AudioWaveMapping : public AudioChannelMapping {
 		public:
-			AudioWaveMapping(int channel, AudioControlMapping* control, AudioDebugMapping* debug, WaveMemoryMapping* wavePatternMapping, HardwareStatus* hardware);
+			AudioWaveMapping(int channel, AudioControlMapping* control, AudioDebugMapping* debug, AudioMixer* mixer, WaveMemoryMapping* wavePatternMapping, HardwareStatus* hardware);
 
 			uint8_t get(uint16_t address);
 			void set(uint16_t address, uint8_t value);
@@ -41,7 +41,7 @@ namespace toygb {
 			float buildSample();
 			void onPowerOn();
 			void onPowerOff();
-			void onUpdate();
+			void onUpdate(uint64_t cycle, int cycles);
 			void onLengthFrame();
 			void disable();
 			void start();
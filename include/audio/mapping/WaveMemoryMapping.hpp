@@ -14,11 +14,15 @@ namespace toygb {
 			uint8_t get(uint16_t address);
 			void set(uint16_t address, uint8_t value);
 
+			// Accesses from the CPU depend on the wave channel state, they must always go through get() and set()
+			uint8_t* getReadPointer(uint16_t address);
+			uint8_t* getWritePointer(uint16_t address);
+
 			// Access by the APU (unchecked and untransformed)
 			uint8_t waveGet(uint16_t address);
 			void waveSet(uint16_t address, uint8_t value);
 
-			void update();  // Called at every APU cycle while the wave channel is active
+			void update(int cycles);  // Called with the APU cycles that have passed while the wave channel is active
 
 			void setPlaying(bool playing);         // For the APU to tell whether the wave channel is playing
 			void setCurrentIndex(uint16_t index);  // Tell that the given index is being read by the APU
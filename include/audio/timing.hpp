@@ -6,17 +6,25 @@
 // APU updates every 2 clocks (0x200000 Hz)
 #define APU_CLOCK_FREQUENCY (CLOCK_FREQUENCY / 2)
 
-// Arbitrary output sample rate, better if it is a divisor of the APU clock frequency
+// Output sample rate, exactly 3/128 of the APU clock frequency (see AudioMixer)
 #define OUTPUT_SAMPLE_FREQUENCY 49152
 
 // Frame sequencer low-frequency clock, 512Hz
 #define FRAME_SEQUENCER_FREQUENCY 512
 
-// Output and frame sequencer periods in APU cycles (= period in clocks / 2)
-#define OUTPUT_SAMPLE_PERIOD (APU_CLOCK_FREQUENCY / OUTPUT_SAMPLE_FREQUENCY)
+// Frame sequencer period in APU cycles (= period in clocks / 2)
 #define FRAME_SEQUENCER_PERIOD (APU_CLOCK_FREQUENCY / FRAME_SEQUENCER_FREQUENCY)
 
+// Maximum amount of APU cycles between two catch-ups of the APU, to keep the audio output supplied (~2ms)
+#define OUTPUT_UPDATE_PERIOD 4096
+
 // Arbitrary amount of samples per buffer, empirically 1024 is not too bad with SFML
 #define OUTPUT_BUFFER_SAMPLES 2048
 
+// Audio-synced pacing (see Gameboy::main) : amount of samples to keep waiting for the audio output,
+// maximum relative adjustment of the output sample rate, and amount of clock blocks between two adjustments (~4ms)
+#define AUDIO_TARGET_LATENCY (2*OUTPUT_BUFFER_SAMPLES)
+#define AUDIO_MAX_RATE_DELTA 0.005
+#define AUDIO_RATE_CONTROL_BLOCKS 40
+
 #endif
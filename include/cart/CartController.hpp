@@ -41,9 +41,6 @@ namespace toygb {
 			bool hasBattery() const;  // Check whether the cartridge has a battery (= saves its RAM)
 			bool hasRTC() const;      // Check whether the cartridge has a Real-Time Clock
 
-			/** Update the cartridge status, like the RTC */
-			void update();
-
 		private:
 			std::string m_romfile;
 			std::string m_ramfile;
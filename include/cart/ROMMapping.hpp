@@ -5,6 +5,7 @@
 #include <fstream>
 
 #include "core/hardware.hpp"
+#include "memory/Constants.hpp"
 #include "memory/MemoryMapping.hpp"
 #include "util/error.hpp"
 
@@ -33,8 +34,8 @@ namespace toygb {
 			bool hasBattery() const;  // Check whether the cartridge has a battery (= saves its RAM)
 			bool hasRTC() const;      // Check whether the cartridge has a Real-Time Clock
 
-			/** Update the cartridge status, like the RTC. Called at every clock tick */
-			virtual void update();
+			/** ROM banks are always plain memory and can be read directly from the currently mapped banks */
+			virtual uint8_t* getReadPointer(uint16_t address);
 
 		protected:
 			/** Set the cartridge features as defined by the cartridge type identifier in the ROM header, for use by subclasses. */
@@ -44,6 +45,10 @@ namespace toygb {
 			void loadCartData();
 			void loadSaveData(MemoryMapping* ramMapping);
 
+			/** Map the given ROM banks into the fixed (0x0000-0x3FFF) and switchable (0x4000-0x7FFF) areas, and update the memory map accordingly
+			 *  Must be called by subclasses at startup and each time the selected banks change */
+			void mapROMBanks(int fixedBank, int switchableBank);
+
 			HardwareStatus* m_hardware;
 
 			std::string m_romFile;  // ROM file name
@@ -52,6 +57,8 @@ namespace toygb {
 			int m_romSize;  // ROM size in bytes
 			int m_ramSize;  // RAM size in bytes
 			uint8_t* m_romData;  // Full ROM data
+			uint8_t* m_fixedBank;       // ROM data currently mapped into 0x0000-0x3FFF
+			uint8_t* m_switchableBank;  // ROM data currently mapped into 0x4000-0x7FFF
 			uint8_t* m_ramData;  // Full RAM data
 			uint8_t m_cartType;  // Cartridge type identifier, from 0x0147 in the ROM header
 
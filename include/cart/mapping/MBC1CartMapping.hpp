@@ -26,6 +26,8 @@ namespace toygb {
 			virtual MemoryMapping* getRAM();
 
 		protected:
+			void updateBanks();  // Map the selected ROM and RAM banks after a change of the bank registers
+
 			MBC1RAMMapping* m_ramMapping;  // Associated cart RAM mapping
 
 			int m_romBanks;
@@ -7,7 +7,7 @@
 
 namespace toygb {
 	/** MBC2 ROM memory mapping
-	 * TODO : not implemented */
+	 * TODO : the built-in 512x4 bits RAM is not implemented */
 	class MBC2CartMapping : public ROMMapping {
 		public:
 			/** Initialize the mapping
@@ -25,6 +25,9 @@ namespace toygb {
 
 		protected:
 			ArrayMemoryMapping* m_ramMapping;  // Associated cart RAM mapping
+
+			// Internal registers
+			uint8_t m_romBankSelect;
 	};
 }
 
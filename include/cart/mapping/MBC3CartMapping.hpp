@@ -23,9 +23,6 @@ namespace toygb {
 			/** Return the associated cartridge RAM mapping */
 			virtual MemoryMapping* getRAM();
 
-			/** Update the RTC status */
-			virtual void update();
-
 		protected:
 			uint8_t m_romBankSelect;
 			uint8_t m_ramBankSelect;
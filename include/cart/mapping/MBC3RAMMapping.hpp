@@ -3,6 +3,7 @@
 
 #include <iostream>
 
+#include "core/hardware.hpp"
 #include "core/timing.hpp"
 #include "memory/mapping/FullBankedMemoryMapping.hpp"
 
@@ -28,8 +29,9 @@ namespace toygb {
 			 * uint8_t* array      : RAM content, must be of size (numBanks * bankSize)
 			 * bool accessible     : Whether the memory mapping is accessible initially
 			 * MBC3RTC rtc         : Value of the actual RTC registers (nullptr if there is no RTC)
-			 * MBC3RTC rtcLatch    : Latched RTC registers values (nullptr if there is no RTC) */
-			MBC3RAMMapping(uint8_t* bankSelect, int numBanks, uint16_t bankSize, uint8_t* array, bool accessible, MBC3RTC* rtc, MBC3RTC* rtcLatch);
+			 * MBC3RTC rtcLatch    : Latched RTC registers values (nullptr if there is no RTC)
+			 * HardwareStatus* hardware : Hardware status, used as the RTC time base */
+			MBC3RAMMapping(uint8_t* bankSelect, int numBanks, uint16_t bankSize, uint8_t* array, bool accessible, MBC3RTC* rtc, MBC3RTC* rtcLatch, HardwareStatus* hardware);
 
 			virtual uint8_t get(uint16_t address);
 			virtual void set(uint16_t address, uint8_t value);
@@ -37,9 +39,16 @@ namespace toygb {
 			virtual void load(std::istream& input);
 			virtual void save(std::ostream& output);
 
+			/** Bring the RTC registers up to date with the emulated time */
+			void updateRTC();
+
 		protected:
+			void advanceRTC(uint64_t ticks);  // Advance the RTC registers by the given amount of 32768Hz ticks
+
 			MBC3RTC* m_rtc;
 			MBC3RTC* m_rtcLatch;
+			HardwareStatus* m_hardware;
+			uint64_t m_rtcTimestamp;  // Emulated timestamp the RTC registers are up to date with (see HardwareStatus::getTimestamp)
 	};
 }
 
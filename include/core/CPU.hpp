@@ -37,6 +37,20 @@ namespace toygb {
 			/** Tell whether the emulator can skip the component on that cycle, to save a context commutation */
 			bool skip();
 
+			/** Tell in how many clocks the CPU needs to be resumed (assuming the CPU is not stopped) */
+			int nextEvent();
+
+			/** Skip the given amount of clocks without resuming the CPU, they must all be before nextEvent() */
+			void fastForward(int clocks);
+
+			/** Set the amount of clocks from the current one until the next event of a component that may change what the CPU observes (everything but the APU)
+			 *  Must be set before resuming the CPU, busy-wait loops are skipped up to that point */
+			void setEventHorizon(int clocks);
+
+			uint64_t instructionCount() const;  // Return the number of instructions executed since startup
+			uint64_t idleLoopHits() const;      // Return the number of times a busy-wait loop has been skipped
+			uint64_t idleLoopCycles() const;    // Return the total number of CPU cycles skipped in busy-wait loops
+
 		private:
 			// General utilities
 			bool loadBootrom(std::string filename);                         // Load the bootrom into memory and tell whether loading was successful
@@ -48,6 +62,7 @@ namespace toygb {
 			bool checkCondition(uint8_t condition);                         // Evaluate a conditional instruction's condition (as specified by the condition identifier in the opcode z, c, nz, nc)
 			void setFlags(uint8_t z, uint8_t n, uint8_t h, uint8_t c);      // Set the flags to the given value, or UNAFFECTED
 			void accumulatorOperation(uint8_t operation, uint8_t operand);  // Perform an arithmetical operation (as specified by the operation identifier in the opcode) on the accumulator, with the given operand
+			int detectIdleLoop(uint16_t address, int* instructions);        // Tell whether the code at the given address is a busy-wait loop that would not change anything, and return the length of an iteration in CPU cycles (0 if it is not) and its number of instructions
 			void increment16(uint8_t* high, uint8_t* low);                  // Increment a 16-bits coupled register (high is the higher byte register, low the lower byte register)
 			void decrement16(uint8_t* high, uint8_t* low);                  // Decrement a 16-bits coupled register
 			uint16_t get16(uint8_t identifier);                             // Get the value of a 16-bits register, as specified by the identifier in the opcode
@@ -87,6 +102,7 @@ namespace toygb {
 			bool m_halted;     // HALT status (set by the halt instruction)
 			bool m_haltBug;    // Whether the halt instruction was just used in a situation that causes the program counter to not be incremented
 			int m_haltCycles;  // Number of CPU cycles to stay in HALT mode before exiting it automatically (like during speed switch)
+			bool m_idle;       // Whether the CPU is in HALT mode with nothing else to do than waiting for an interrupt
 
 			uint8_t m_lastStatMode;  // Last known STAT mode (used to detect when to resume HBlank HDMA)
 
@@ -94,6 +110,11 @@ namespace toygb {
 			int m_dividerCounter;  // Counts cycles for the DIV register timer
 
 			int m_cyclesToSkip;
+			uint64_t m_instructionCount;  // Number of instructions executed (not counting interrupt dispatches and halt cycles)
+
+			int m_eventHorizon;         // Clocks until the next event that may change what the CPU observes (see setEventHorizon)
+			uint64_t m_idleLoopHits;    // Number of busy-wait loops skipped
+			uint64_t m_idleLoopCycles;  // Total number of CPU cycles skipped in busy-wait loops
 	};
 }
 
@@ -1,11 +1,14 @@
 #ifndef _CORE_OPERATIONMODE_HPP
 #define _CORE_OPERATIONMODE_HPP
 
+#include <algorithm>
 #include <string>
 
 #include "core/InterruptVector.hpp"
+#include "core/timing.hpp"
 #include "core/mapping/TimerMapping.hpp"
 #include "memory/MemoryMap.hpp"
+#include "util/component.hpp"
 #include "util/error.hpp"
 
 
@@ -74,15 +77,20 @@ namespace toygb {
 
 			// Component initialization and configuration
 			void init(InterruptVector* interrupts);
+			void setLazyComponent(LazyComponent* component);  // Component to catch up before the divider, speed mode or STOP mode change
 			void configureMemory(MemoryMap* memory);
 			void update();
+			void fastForward(int clocks);  // Skip the given amount of clocks at once, must not cross nextEvent() nor STOP mode changes
+			int nextEvent();               // Clocks until the next timer event or the end of a speed switch, NO_EVENT if there is none
 
 			// Return the emulator components sequence counter value
 			uint16_t getSequencer() const;
 
+			// Return the emulated time since startup, in units of 1/8388608 second (one clock in double-speed mode, half a clock in single-speed mode)
+			uint64_t getTimestamp() const;
+
 			// Divider internal counter
 			uint16_t getDivider() const;
-			void incrementDivider();
 			void resetDivider();
 
 			// Generic console model checks
@@ -101,6 +109,7 @@ namespace toygb {
 			ConsoleModel defaultConsoleModel(OperationMode mode);
 			ConsoleModel defaultConsoleModel(SystemRevision system);
 			SystemRevision defaultSystemRevision(ConsoleModel console);
+			void catchUpLazyComponent();
 
 			ConsoleModel m_console;
 			OperationMode m_mode;
@@ -113,8 +122,10 @@ namespace toygb {
 
 			// Clock status
 			uint16_t m_sequencer;     // Emulator components sequencer, to clock the components at the right time (CPU, audio)
-			uint16_t m_divider;  // Gameboy internal divider, used for timer IO and audio frame sequencer
+			uint64_t m_timestamp;     // Emulated time since startup, that does not depend on the speed mode
+			uint64_t m_timerClock;    // Number of clocks the gameboy internal divider has been ticking for, used for timer IO and audio frame sequencer
 			TimerMapping* m_timerMapping;
+			LazyComponent* m_lazyComponent;
 	};
 }
 
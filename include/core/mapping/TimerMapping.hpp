@@ -5,6 +5,7 @@
 #include "memory/Constants.hpp"
 #include "memory/MemoryMapping.hpp"
 #include "util/bits.hpp"
+#include "util/component.hpp"
 #include "util/error.hpp"
 
 
@@ -12,12 +13,21 @@ namespace toygb {
 	/** Timer IO registers memory mapping */
 	class TimerMapping : public MemoryMapping {
 		public:
-			TimerMapping(uint16_t* divider, InterruptVector* interrupt);
+			/** Initialize the memory mapping
+			 * const uint64_t* clock        : Number of clocks the internal counter has been ticking for since startup (it does not tick in STOP mode)
+			 * InterruptVector* interrupt  : Global interrupt vector */
+			TimerMapping(const uint64_t* clock, InterruptVector* interrupt);
 
 			uint8_t get(uint16_t address);
 			void set(uint16_t address, uint8_t value);
 
-			void dividerChange(uint16_t newValue);  // Update the timer status for a change from the current value of the divider to the given one
+			uint16_t divider() const;  // Get the current value of the internal counter
+			void resetDivider();       // Reset the internal counter to 0, with its side-effects on TIMA
+
+			void setLazyComponent(LazyComponent* component);  // Component to catch up before any divider reset
+
+			void update();                // Bring TIMA up to date with the current clock
+			uint64_t nextEvent() const;   // Clock at which update() must be called at the latest to trigger the next timer interrupt on time, UINT64_MAX if there is none
 
 			uint8_t counter;      // Timer counter (register TIMA)
 			uint8_t modulo;       // Timer modulo (register TMA)
@@ -25,9 +35,15 @@ namespace toygb {
 			uint8_t clockSelect;  // Select the increment frequency of TIMA (register TAC, bits 0-1)
 
 		private:
+			uint64_t countTriggers(uint64_t start, uint64_t end) const;  // Count the TIMA trigger bit falling edges between the given clocks (start excluded, end included)
+			void incrementCounter();                                      // Increment TIMA, and handle its overflow
+
 			InterruptVector* m_interrupt;
+			LazyComponent* m_lazyComponent;
 
-			uint16_t* m_divider;        // Internal time counter, that counts clock ticks
+			const uint64_t* m_clock;    // Current clock, counts internal counter ticks
+			uint64_t m_dividerOrigin;   // Clock at which the internal counter was last reset, the internal counter is the 16 lower bits of (clock - origin)
+			uint64_t m_lastUpdate;      // Clock up to which TIMA has been updated
 			uint8_t m_timaReloadDelay;  // When TIMA has overflown, time before it is reloaded with TMA
 	};
 }
@@ -26,7 +26,14 @@
 // Minimum time to realign the clock timing by
 #define MIN_WAIT_TIME_NS (BLOCK_CYCLES*CLOCK_CYCLE_NS)
 
+// Returned by the components’ nextEvent() when they have nothing to do until another component changes their state
+#define NO_EVENT INT_MAX
+
+// Number of clocks until the sequencer reaches the next multiple of (mask + 1), with mask = 2^n - 1 (1 = the next clock)
+#define CLOCKS_TO_SEQUENCER(sequencer, mask) (((mask) + 1) - ((sequencer) & (mask)))
+
 #include <chrono>
+#include <climits>
 
 namespace toygb {
 	typedef std::chrono::time_point<std::chrono::steady_clock> clocktime_t;
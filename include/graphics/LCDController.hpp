@@ -1,13 +1,17 @@
 #ifndef _GRAPHICS_LCDCONTROLLER_HPP
 #define _GRAPHICS_LCDCONTROLLER_HPP
 
-#include <queue>
-#include <deque>
+#include <atomic>
 #include <algorithm>
+#include <utility>
 
 #include "core/timing.hpp"
 #include "core/hardware.hpp"
 #include "core/InterruptVector.hpp"
+#include "graphics/PixelFormat.hpp"
+#include "graphics/LineKernels.hpp"
+#include "graphics/ObjectLineCache.hpp"
+#include "graphics/TileCache.hpp"
 #include "graphics/mapping/OAMMapping.hpp"
 #include "graphics/mapping/LCDControlMapping.hpp"
 #include "graphics/mapping/DMGPaletteMapping.hpp"
@@ -22,6 +26,9 @@
 #define LCD_WIDTH 160
 #define LCD_HEIGHT 144
 
+// Capacity of the pixel FIFOs (must be a power of 2)
+#define PIXEL_FIFO_SIZE 16
+
 
 namespace toygb {
 	/** Implementation of the Picture Processing Unit and LCD screen */
@@ -30,7 +37,7 @@ namespace toygb {
 			LCDController();
 			~LCDController();
 
-			void init(HardwareStatus* hardware, InterruptVector* interrupt);
+			void init(HardwareStatus* hardware, InterruptVector* interrupt, PixelFormat format);
 			void configureMemory(MemoryMap* memory);
 
 			/** Main loop of the component, as a coroutine */
@@ -39,7 +46,24 @@ namespace toygb {
 			/** Tell whether the emulator can skip the component on that cycle, to save a context commutation */
 			bool skip();
 
-			uint16_t* pixels();  // Return the full pixels buffer, as a CGB RGB555 bitmap (even in DMG mode)
+			/** Tell in how many clocks the PPU needs to be resumed, or NO_EVENT if it is disabled */
+			int nextEvent();
+
+			/** Skip the given amount of clocks without resuming the PPU, they must all be before nextEvent() */
+			void fastForward(int clocks);
+
+			/** Frame output, for the interface thread. Never blocks the PPU */
+			bool hasNewFrame() const;     // Tell whether a frame has been completed since the last call to pixels()
+			uint8_t* pixels();            // Return the latest complete frame, in the pixel format given to init(). It stays untouched until the next call
+			PixelFormat pixelFormat() const;  // Return the format of the frames returned by pixels()
+			uint64_t pixelsFrame() const; // Return the number of the frame returned by the last call to pixels()
+
+			uint64_t frameCount() const;  // Return the number of frames rendered since startup
+
+			/** Frame skipping : the PPU keeps all its timings and interrupts, but only draws 1 frame out of frameSkip (1 = every frame),
+			 *  or only the frames requested with requestFrame() if frameSkip is 0 (the F key in the interface). Skipped frames are not handed over to the interface */
+			void setFrameSkip(int frameSkip);
+			void requestFrame();  // Draw the next frame that starts, regardless of the frame skipping. Can be called from any thread
 
 		private:
 			/** Comparator for sprite rendering order */
@@ -53,17 +77,55 @@ namespace toygb {
 					LCDMemoryMapping* m_oamMapping;
 			};
 
-			/** Pixel information, as pushed onto a pixel FIFO */
+			/** Pixel information, as pushed onto a pixel FIFO, packed into 16 bits :
+			 *  bits 0-1 = color, bit 2 = priority, bits 3-6 = palette, bits 7-12 = index of the object in OAM */
 			class Pixel {
 				public:
+					Pixel();
 					Pixel(uint8_t color, uint8_t palette, uint16_t oamAddress, bool priority);
 
-					uint8_t color;        // 2-bits color value
-					uint8_t palette;      // Palette to use
-					uint16_t oamAddress;  // Address of the object in OAM
-					uint8_t priority;     // Pixel priority value
+					uint8_t color() const;        // 2-bits color value
+					uint8_t palette() const;      // Palette to use
+					uint16_t oamAddress() const;  // Address of the object in OAM
+					uint8_t priority() const;     // Pixel priority value
+
+				private:
+					uint16_t m_data;
+			};
+
+			/** Fixed-capacity pixel FIFO, as a ring buffer */
+			class PixelFIFO {
+				public:
+					PixelFIFO();
+
+					bool empty() const;
+					Pixel front() const;
+					void push(Pixel pixel);
+					void pop();
+					void clear();
+
+				private:
+					Pixel m_pixels[PIXEL_FIFO_SIZE];
+					uint8_t m_start;  // Index of the first pixel in the ring buffer
+					uint8_t m_size;   // Number of pixels in the FIFO
 			};
 
+			/** How the PPU waits for its next clocks (see LCDController::waitClocks) */
+			enum class RenderMode {
+				Dots,     // Suspend on every wait
+				Batch,    // Run the current mode of the scanline ahead of time, without suspending
+				Waiting,  // Waiting for the end of a scanline rendered ahead of time
+				Replay,   // Render the current scanline again from the start of the mode, up to the register write that interrupted the wait
+			};
+
+			const uint8_t* tileRowData(uint16_t tileAddress, int row, bool flipped);
+			int renderLine(int line, int windowLineCounter, const uint16_t* selectedSprites, int selectedCount, bool* hasWindow, bool draw);
+			bool waitClocks(int clocks);
+			void startLine();
+			bool lineChanged();
+			void swapLineRegisters();
+			void stopDisplay();
+
 			HardwareStatus* m_hardware;
 			InterruptVector* m_interrupt;
 
@@ -79,11 +141,40 @@ namespace toygb {
 			uint8_t* m_vram;
 			uint8_t* m_oam;
 			uint8_t m_vramBank;
-
-			// The whole thing is double-buffered
-			uint16_t* m_frontBuffer;
-			uint16_t* m_backBuffer;
-
+			TileCache* m_tileCache;  // Tile data from m_vram, already decoded
+			ObjectLineCache* m_objectCache;  // Objects selected on each scanline from m_oam
+
+			// The whole thing is triple-buffered : the PPU renders into the back buffer while the interface reads the front buffer,
+			// and complete frames are exchanged through the shared buffer so that neither ever waits for the other
+			uint8_t* m_buffers[3];
+			uint64_t m_bufferFrames[3];       // Number of the frame held by each buffer
+			int m_backBuffer;                 // Index of the buffer being rendered, only used by the PPU
+			int m_frontBuffer;                // Index of the buffer being displayed, only used by the interface
+			std::atomic<int> m_sharedBuffer;  // Index of the buffer in-between, with FRAMEBUFFER_READY_FLAG if it holds a frame that has not been displayed yet
+
+			// Pixels are rendered directly in the host format, the palette mappings hold the converted colors
+			PixelFormat m_pixelFormat;
+			int m_pixelSize;                  // Size of a pixel in the buffers, in bytes
+			uint32_t m_blankColor;            // Host-format color of blank pixels
+
+			// Scanline rendering ahead of time
+			RenderMode m_renderMode;
+			uint64_t m_clock;                 // Number of clocks since startup, counted in skip() and fastForward()
+			uint64_t m_lineStart;             // Value of m_clock at the start of the current mode
+			int m_lineClocks;                 // Clocks since the start of the mode the PPU has reached ahead of time
+			int m_lineWrite;                  // Clocks between the start of the mode and the register write that interrupted the wait
+			bool m_lineDoubleSpeed;           // Speed mode at the start of the mode
+			LCDControlMapping* m_lineControl;  // Copies of the registers at the start of the mode, swapped with the actual ones during a replay
+			DMGPaletteMapping* m_linePalette;
+
+			uint64_t m_frameCount;  // Number of frames fully rendered (incremented when entering VBlank)
+
+			// Frame skipping
+			int m_frameSkip;                       // Draw 1 frame out of m_frameSkip, 0 = only the requested ones
+			bool m_drawFrame;                      // Whether the current frame is drawn
+			std::atomic<bool> m_frameRequested;   // Whether the next frame must be drawn anyway
+
+			bool m_displayStopped;  // Whether the LCD has been disabled since the PPU was last resumed, the current frame is then abandoned
 			int m_cyclesToSkip;
 	};
 }
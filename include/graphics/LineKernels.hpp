@@ -0,0 +1,48 @@
+#ifndef _GRAPHICS_LINEKERNELS_HPP
+#define _GRAPHICS_LINEKERNELS_HPP
+
+#include <cstdint>
+
+// Number of pixels composed at once by composeLine and writeLine (LCD_WIDTH)
+#define LINE_PIXELS 160
+
+// Layer pixel values given to composeLine : bits 0-1 = color, bits 2-4 = palette, bit 7 = priority bit
+// Bits 0-4 are thus the index of the color in the background or objects part of the line color table
+#define LAYER_INDEX_MASK 0x1F
+#define LAYER_PALETTE_SHIFT 2
+#define LAYER_PRIORITY 0x80
+
+// Line color table : 8 background palettes, 8 object palettes, then the blank color
+#define LINE_COLORS_BACKGROUND 0
+#define LINE_COLORS_OBJECTS 32
+#define LINE_COLORS_BLANK 64
+#define LINE_COLORS_SIZE 65
+
+
+namespace toygb {
+	/** Sets of kernel implementations, selected at runtime according to what the host CPU supports */
+	enum class KernelSet {
+		Scalar,  // Portable C++
+		SSE2,
+		AVX2,
+	};
+
+	/** Get the fastest kernel set the host CPU supports, that is used by default */
+	KernelSet bestKernelSet();
+
+	/** Use the given kernel set from now on, it must be supported by the host CPU */
+	void useKernelSet(KernelSet set);
+
+	/** Decode the 8 rows of a tile from its 16 bytes of VRAM data into one 2-bits color index per pixel, left to right,
+	 *  both as-is into normal and flipped horizontally into flipped (64 bytes each) */
+	void decodeTileRows(const uint8_t* data, uint8_t* normal, uint8_t* flipped);
+
+	/** Merge the background / window and object layers of a line into indices in the line color table, with the priority rules described in LCDController::run
+	 *  Object pixels with color 0 are transparent. If blankBackground is set, background pixels are replaced by the blank color */
+	void composeLine(const uint8_t* background, const uint8_t* objects, uint8_t* indices, bool backgroundDisplay, bool blankBackground);
+
+	/** Write a line of host-format pixels (see writePixel) from indices in the given line color table */
+	void writeLine(const uint8_t* indices, const uint32_t* colors, uint8_t* output, int pixelSize);
+}
+
+#endif
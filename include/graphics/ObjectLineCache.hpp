@@ -0,0 +1,52 @@
+#ifndef _GRAPHICS_OBJECTLINECACHE_HPP
+#define _GRAPHICS_OBJECTLINECACHE_HPP
+
+#include <bit>
+#include <cstdint>
+
+#include "memory/Constants.hpp"
+
+// Number of objects in OAM, 4 bytes each
+#define OAM_OBJECTS (OAM_SIZE / 4)
+// Maximum number of objects rendered on a single scanline
+#define MAX_LINE_OBJECTS 10
+// Number of scanlines the objects can be rendered on (LCD_HEIGHT)
+#define OBJECT_LINES 144
+
+
+namespace toygb {
+	/** Objects selected by the OAM scan for each scanline, maintained from the writes into OAM
+	 *  Each scanline keeps the set of objects on it, and the resulting selection is sorted again on its next use after any change of their coordinates */
+	class ObjectLineCache {
+		public:
+			ObjectLineCache(const uint8_t* oam);
+
+			/** Tell that the value at the given OAM address has changed */
+			inline void invalidate(uint16_t address) {
+				if (address % 4 == 0)
+					moveObject(address / 4);
+				else if (address % 4 == 1)
+					markLines(address / 4);
+			}
+
+			/** Get the OAM addresses of the objects the OAM scan selects on the given scanline with the given object size (LCDC.2),
+			 *  sorted in rendering order, into objects (MAX_LINE_OBJECTS entries), and return their number */
+			int lineObjects(int line, bool objectSize, uint16_t* objects);
+
+		private:
+			void build(bool objectSize);
+			void moveObject(int object);
+			void markLines(int object);
+			void sortLine(int line);
+
+			const uint8_t* m_oam;
+			bool m_objectSize;                    // Object size the cache is built for
+			uint8_t m_objectY[OAM_OBJECTS];       // Y coordinate each object is registered with in m_lineMasks (OAM value - 16)
+			uint64_t m_lineMasks[OBJECT_LINES];   // Objects on each scanline, bit n = object n in OAM, regardless of the 10 objects limit
+			uint16_t m_lineObjects[OBJECT_LINES][MAX_LINE_OBJECTS];  // Selected objects on each scanline, sorted in rendering order
+			uint8_t m_lineCounts[OBJECT_LINES];   // Number of selected objects in m_lineObjects
+			bool m_lineDirty[OBJECT_LINES];       // Whether m_lineObjects must be sorted again before its next use
+	};
+}
+
+#endif
@@ -0,0 +1,34 @@
+#ifndef _GRAPHICS_PIXELFORMAT_HPP
+#define _GRAPHICS_PIXELFORMAT_HPP
+
+#include <cstdint>
+#include <cstring>
+
+
+namespace toygb {
+	/** Host pixel formats the PPU can render into, named by the order of the components in memory */
+	enum class PixelFormat {
+		RGBA8888,  // 4 bytes per pixel : red, green, blue, alpha
+		BGRA8888,  // 4 bytes per pixel : blue, green, red, alpha
+		RGB565,    // 16-bits host-endian values per pixel : 5 bits red, 6 bits green, 5 bits blue, from the MSB
+	};
+
+	/** Size of a pixel in the given format, in bytes */
+	int pixelSize(PixelFormat format);
+
+	/** Convert a CGB RGB555 color value into the given host format
+	 *  The value must then be written into the pixel buffer with writePixel */
+	uint32_t hostColor(uint16_t color, PixelFormat format);
+
+	/** Write a color returned by hostColor into a pixel buffer, at the given pixel index */
+	inline void writePixel(uint8_t* buffer, int index, uint32_t color, int size) {
+		if (size == 4) {
+			std::memcpy(buffer + 4*index, &color, 4);
+		} else {
+			uint16_t shortColor = color;
+			std::memcpy(buffer + 2*index, &shortColor, 2);
+		}
+	}
+}
+
+#endif
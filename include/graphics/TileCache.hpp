@@ -0,0 +1,48 @@
+#ifndef _GRAPHICS_TILECACHE_HPP
+#define _GRAPHICS_TILECACHE_HPP
+
+#include <cstdint>
+
+#include "memory/Constants.hpp"
+
+// Tile data area at the beginning of each VRAM bank : 384 tiles of 8 rows of 2 bytes
+#define TILE_DATA_SIZE 0x1800
+#define TILE_SIZE 16
+#define TILES_PER_BANK (TILE_DATA_SIZE / TILE_SIZE)
+
+
+namespace toygb {
+	/** Cache of the VRAM tile data, decoded as one 2-bits color index per byte
+	 *  Each row is kept both as-is and flipped horizontally, and a tile is decoded again on its next use after any write to its data */
+	class TileCache {
+		public:
+			TileCache(const uint8_t* vram, int banks);
+			~TileCache();
+
+			/** Tell that the value at the given VRAM array index (bank * VRAM_BANK_SIZE + relative address) has changed */
+			inline void invalidate(uint16_t address) {
+				uint16_t bankAddress = address % VRAM_BANK_SIZE;
+				if (bankAddress < TILE_DATA_SIZE)
+					m_dirty[(address / VRAM_BANK_SIZE) * TILES_PER_BANK + bankAddress / TILE_SIZE] = true;
+			}
+
+			/** Get the 8 color indices of a tile row, from left to right
+			 *  tileAddress is the VRAM array index of the tile data (bank * VRAM_BANK_SIZE + relative address), row is 0-7 */
+			inline const uint8_t* row(uint16_t tileAddress, int row, bool flipped) {
+				int tile = (tileAddress / VRAM_BANK_SIZE) * TILES_PER_BANK + (tileAddress % VRAM_BANK_SIZE) / TILE_SIZE;
+				if (m_dirty[tile])
+					decode(tile);
+				return m_rows + ((tile * 2 + flipped) * 8 + row) * 8;
+			}
+
+		private:
+			void decode(int tile);
+
+			const uint8_t* m_vram;
+			int m_tiles;      // Number of tiles in the cache (TILES_PER_BANK per VRAM bank)
+			uint8_t* m_rows;  // Decoded rows, as [tile][flipped][row][pixel]
+			bool* m_dirty;    // Whether each tile must be decoded again before its next use
+	};
+}
+
+#endif
@@ -1,6 +1,7 @@
 #ifndef _GRAPHICS_MAPPING_DMGPALETTEMAPPING_HPP
 #define _GRAPHICS_MAPPING_DMGPALETTEMAPPING_HPP
 
+#include "graphics/PixelFormat.hpp"
 #include "memory/Constants.hpp"
 #include "memory/MemoryMapping.hpp"
 #include "util/error.hpp"
@@ -10,7 +11,7 @@ namespace toygb {
 	/** DMG palettes and window position (as it is contiguous...) IO registers memory mapping */
 	class DMGPaletteMapping : public MemoryMapping {
 		public:
-			DMGPaletteMapping();
+			DMGPaletteMapping(PixelFormat format);
 
 			virtual uint8_t get(uint16_t address);
 			virtual void set(uint16_t address, uint8_t value);
@@ -20,10 +21,21 @@ namespace toygb {
 			uint8_t objectPalette0[4];     // Same for object palette 0 (accessible from register OBP0)
 			uint8_t objectPalette1[4];     // Same for object palette 1 (accessible from register OBP1)
 
+			// Host-format colors for each 2-bits palette index, updated when the palettes are written
+			uint32_t backgroundColors[4];
+			uint32_t objectColors0[4];
+			uint32_t objectColors1[4];
+
 			// Window position
 			uint8_t windowY;  // Position of the left of the window on the screen
 			uint8_t windowX;  // Position of the top of the window on the screen
 
+			uint64_t renderWrites;  // Number of writes that changed any of those registers, for the PPU to detect changes in the middle of a scanline
+
+		private:
+			void updateColors(uint32_t* colors, uint8_t* palette);
+
+			uint32_t m_shades[4];  // Host-format values of the default DMG colors
 	};
 }
 
@@ -8,7 +8,7 @@ namespace toygb {
 	/** Banked memory memory with PPU access */
 	class LCDBankedMemoryMapping : public LCDMemoryMapping {
 		public:
-			LCDBankedMemoryMapping(uint8_t* bankSelect, uint16_t bankSize, uint8_t* array);
+			LCDBankedMemoryMapping(uint8_t* bankSelect, uint16_t bankSize, uint8_t* array, TileCache* tileCache = nullptr);
 
 			// Access from the CPU (blocked when accessed by the PPU)
 			virtual uint8_t get(uint16_t address);
@@ -41,6 +41,8 @@ namespace toygb {
 			uint8_t coordY;         // Current scanline being rendered (register LY)
 			uint8_t coordYCompare;  // Value the scanline must be compared against (register LYC)
 
+			uint64_t renderWrites;  // Number of writes that changed LCDC, SCX or SCY, for the PPU to detect changes in the middle of a scanline
+
 		private:
 			void shutdownPPU();  // Called when the PPU is shut down (LCDC.7 goes 1 -> 0)
 
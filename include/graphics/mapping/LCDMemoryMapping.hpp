@@ -2,12 +2,13 @@
 #define _GRAPHICS_MAPPING_LCDMEMORYMAPPING_HPP
 
 #include "memory/MemoryMapping.hpp"
+#include "graphics/TileCache.hpp"
 
 namespace toygb {
 	/** Base class for array memories with a specific PPU access */
 	class LCDMemoryMapping : public MemoryMapping {
 		public:
-			LCDMemoryMapping(uint8_t* array);
+			LCDMemoryMapping(uint8_t* array, TileCache* tileCache = nullptr);
 
 			// CPU access : unavailable while the PPU is accessing
 			virtual uint8_t get(uint16_t address);
@@ -21,6 +22,7 @@ namespace toygb {
 
 		protected:
 			uint8_t* m_array;
+			TileCache* m_tileCache;  // Decoded tile data to invalidate on writes, nullptr if the array holds no tile data
 	};
 }
 
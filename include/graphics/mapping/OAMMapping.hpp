@@ -2,6 +2,7 @@
 #define _GRAPHICS_MAPPING_OAMMAPPING_HPP
 
 #include "core/hardware.hpp"
+#include "graphics/ObjectLineCache.hpp"
 #include "graphics/mapping/LCDMemoryMapping.hpp"
 #include "memory/Constants.hpp"
 
@@ -10,7 +11,7 @@ namespace toygb {
 	 *  that is unrelated to OAM but it is contiguous and causes OAM corruption in the same way */
 	class OAMMapping : public LCDMemoryMapping {
 		public:
-			OAMMapping(HardwareStatus* hardware, uint8_t* array);
+			OAMMapping(HardwareStatus* hardware, uint8_t* array, ObjectLineCache* objectCache);
 			~OAMMapping();
 
 			// CPU access, unavailable while the PPU is accessing it
@@ -23,6 +24,7 @@ namespace toygb {
 
 		protected:
 			HardwareStatus* m_hardware;
+			ObjectLineCache* m_objectCache;  // Object selection to update on writes
 
 			// 0xFEA0-0xFEFF area emulation
 			uint8_t* m_fea0;
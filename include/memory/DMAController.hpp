@@ -1,6 +1,7 @@
 #ifndef _MEMORY_DMACONTROLLER_HPP
 #define _MEMORY_DMACONTROLLER_HPP
 
+#include "core/timing.hpp"
 #include "core/hardware.hpp"
 #include "memory/Constants.hpp"
 #include "memory/MemoryMap.hpp"
@@ -22,6 +23,9 @@ namespace toygb {
 			/** Main component, called every 4 clocks */
 			void runCycle();
 
+			/** Tell in how many clocks runCycle() needs to be called, or NO_EVENT if there is no active DMA */
+			int nextEvent();
+
 			bool isOAMDMAActive() const;                  // Tell whether an OAM DMA operation is active
 			bool isConflicting(uint16_t address) const;   // Tell whether a bus conflict with OAM DMA can occur at the given address
 			uint8_t conflictingRead(uint16_t address);    // Get the value that the CPU will read at the given address, accounting for bus conflicts
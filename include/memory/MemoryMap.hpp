@@ -1,7 +1,6 @@
 #ifndef _MEMORY_MEMORYMAP_HPP
 #define _MEMORY_MEMORYMAP_HPP
 
-#include <cmath>
 #include <vector>
 #include <cstdint>
 #include <algorithm>
@@ -12,7 +11,7 @@
 
 namespace toygb {
 	/** General memory map, dispatches memory accesses to their respective memory mappings
-	 *  Mappings are first configured and pushed into an array, then reorganised into a binary search tree for faster dispatch */
+	 *  Mappings are first configured and pushed into an array, then reorganised into a flat page table for faster dispatch */
 	class MemoryMap {
 		public:
 			MemoryMap();
@@ -21,18 +20,35 @@ namespace toygb {
 			/** Configure a memory mapping with its start and end absolute addresses (both INCLUDED) */
 			void add(uint16_t start, uint16_t end, MemoryMapping* mapping);
 
-			/** Once all memory mappings have been configured, build the binary search tree
+			/** Once all memory mappings have been configured, build the page table
 			 *  Must be called before attempting memory accesses, adding new mappings will not take effect before calling build() again */
 			void build();
 
 			// Memory accesses, take an absolute address and dispatch them to their respective memory mappings, giving them a relative address
-			uint8_t get(uint16_t address);
-			void set(uint16_t address, uint8_t value);
+			// Pages that are plain memory are accessed directly without going through their mapping, the others go through dispatchGet / dispatchSet
+			inline uint8_t get(uint16_t address) {
+				uint8_t* page = m_readPages[address >> 8];
+				if (page != nullptr)
+					return page[address & 0xFF];
+				return dispatchGet(address);
+			}
+
+			inline void set(uint16_t address, uint8_t value) {
+				uint8_t* page = m_writePages[address >> 8];
+				if (page != nullptr)
+					page[address & 0xFF] = value;
+				else
+					dispatchSet(address, value);
+			}
+
+			/** Fetch the direct access pointers of the given mapping again, for the given RELATIVE address range (both INCLUDED)
+			 *  This is called by MemoryMapping::updateDirectAccess when the mapping state changes (bank switch, etc) */
+			void updateDirectAccess(MemoryMapping* mapping, uint16_t start, uint16_t end);
 
 			/** Get the memory mapping that handles accesses to the given absolute address */
 			MemoryMapping* getMapping(uint16_t address);
 
-			/** Tree node, contains all information necessary to handle a memory mapping (start and end addresses, and the actual mapping) */
+			/** Mapping node, contains all information necessary to handle a memory mapping (start and end addresses, and the actual mapping) */
 			class Node {
 				public:
 					Node();
@@ -45,6 +61,14 @@ namespace toygb {
 					MemoryMapping* mapping;
 			};
 
+			/** Dispatch information for a single address in a page split between several mappings */
+			class Subpage {
+				public:
+					Node* node;             // Node that handles this address, nullptr if unmapped
+					uint8_t* readPointer;   // Pointer to read the value directly from, nullptr if the read must go through the mapping
+					uint8_t* writePointer;  // Pointer to write the value directly to, nullptr if the write must go through the mapping
+			};
+
 			/** Comparator, sorts mappings in order of increasing start address */
 			class NodeComparator {
 				public:
@@ -52,12 +76,24 @@ namespace toygb {
 			};
 
 		private:
+			uint8_t dispatchGet(uint16_t address);               // Dispatch a memory read that can not be done directly
+			void dispatchSet(uint16_t address, uint8_t value);  // Dispatch a memory write that can not be done directly
 			Node* getNode(uint16_t address);  // Get the node to dispatch the given address to
-			void buildSubtree(int rootindex, int startindex, int endindex);  // Recursive function to build the binary search tree
+			void updatePage(int page);        // Fetch the direct access pointers of the given page from its mappings
+			void clearPages();                // Clear the page table and free the sub-tables
+
+			/** The address space is divided into 256 pages of 256 bytes
+			 *  Pages that are entirely handled by a single mapping are dispatched directly with m_pages,
+			 *  pages that are split between several mappings (like the IO registers page 0xFF00-0xFFFF) get a sub-table with an entry for each address
+			 *  Pages that are plain memory can be accessed directly through m_readPages and m_writePages, without going through the mapping */
+			Node* m_pages[256];          // Node that handles each page, nullptr if the page is unmapped or split
+			Subpage* m_subpages[256];    // Per-address entries for the pages that are split between several mappings, nullptr for the others
+			uint8_t* m_readPages[256];   // Pointer to the host memory to read each page from directly, nullptr if reads must be dispatched to the mapping
+			uint8_t* m_writePages[256];  // Pointer to the host memory to write each page into directly, nullptr if writes must be dispatched to the mapping
 
-			int m_treesize;  // Size of the tree array
-			Node* m_tree;    // Binary search tree ordered by increasing start address, stored in an array (leftChild(index) = 2*index + 1, rightChild(index) = 2*index + 2)
-			std::vector<Node> m_array;  // Temporary array to store configured mappings before building the tree
+			int m_nodesize;  // Size of the nodes array
+			Node* m_nodes;   // Configured mappings ordered by increasing start address, referenced by the page table
+			std::vector<Node> m_array;  // Temporary array to store configured mappings before building the page table
 	};
 }
 
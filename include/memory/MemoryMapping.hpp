@@ -7,9 +7,12 @@
 #include "util/error.hpp"
 
 namespace toygb {
+	class MemoryMap;
+
 	/** Base class for memory mappings */
 	class MemoryMapping {
 		public:
+			MemoryMapping();
 			virtual ~MemoryMapping();
 
 			/** Get the value at the given RELATIVE address (relative to the start address configured in the memory map) */
@@ -23,6 +26,21 @@ namespace toygb {
 
 			/** Save the memory mapping state to a file (like cartridge RAM save or savestates) */
 			virtual void save(std::ostream& output);
+
+			/** Get a pointer to the host memory that holds the value at the given RELATIVE address, if reads there can bypass get(), or nullptr otherwise
+			 *  The memory must be contiguous up to the end of the 256-bytes page, and the pointer must stay valid until the mapping calls updateDirectAccess() */
+			virtual uint8_t* getReadPointer(uint16_t address);
+
+			/** Same as getReadPointer, for writes that can bypass set() */
+			virtual uint8_t* getWritePointer(uint16_t address);
+
+			/** Tell the memory map that the direct access pointers of this mapping have changed (bank switch, access permissions, ...)
+			 *  start and end are the RELATIVE addresses (both INCLUDED) of the affected range */
+			void updateDirectAccess(uint16_t start = 0x0000, uint16_t end = 0xFFFF);
+
+		private:
+			friend class MemoryMap;
+			MemoryMap* m_memoryMap;  // Memory map this mapping has been added to
 	};
 }
 
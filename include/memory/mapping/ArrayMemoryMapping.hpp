@@ -12,6 +12,9 @@ namespace toygb {
 			virtual uint8_t get(uint16_t address);
 			virtual void set(uint16_t address, uint8_t value);
 
+			virtual uint8_t* getReadPointer(uint16_t address);
+			virtual uint8_t* getWritePointer(uint16_t address);
+
 		protected:
 			uint8_t* m_array;
 	};
@@ -1,9 +1,11 @@
 #ifndef _UI_INTERFACE_HPP
 #define _UI_INTERFACE_HPP
 
+#include <atomic>
 #include <SFML/Graphics.hpp>
 #include <SFML/Audio.hpp>
 
+#include "GameboyConfig.hpp"
 #include "audio/AudioController.hpp"
 #include "graphics/LCDController.hpp"
 #include "control/JoypadController.hpp"
@@ -12,22 +14,27 @@
 namespace toygb {
 	class Interface {
 		public:
-			Interface();
+			Interface(GameboyConfig& config);
+
+			/** Pixel format the PPU must render into, so that frames can be uploaded to the texture as-is */
+			static constexpr PixelFormat PIXEL_FORMAT = PixelFormat::RGBA8888;
 
 			void run(LCDController* lcd, AudioController* audio, JoypadController* joypad);
 			bool isStopping();
+			void stop();  // Close the interface from the emulator thread
 
 		private:
 			void setupAudio();
 			void updateJoypad();
-			void updateGraphics(sf::Uint8* pixels);
+			void updateLayout(sf::RenderWindow& window, sf::Sprite& screen);
 
 			LCDController* m_lcd;
 			AudioController* m_audio;
 			JoypadController* m_joypad;
 			GBAudioStream m_audioStream;
 
-			bool m_stopping;
+			bool m_smoothScaling;  // Use bilinear filtering instead of nearest-neighbour to scale the screen
+			std::atomic<bool> m_stopping;  // Set by both the emulator and the UI thread
 	};
 }
 
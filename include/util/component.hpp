@@ -25,6 +25,15 @@ namespace toygb {
 		protected:
 			std::coroutine_handle<promise_type> m_handle;
 	};
+
+	/** Component that is not run on every clock, but catches up with the emulated time when it is needed
+	 * As it works out its past state from the current time, it must also catch up right before the clock state it depends on changes
+	 * (divider reset, speed switch, STOP mode, see HardwareStatus::setLazyComponent) */
+	class LazyComponent {
+		public:
+			virtual ~LazyComponent() = default;
+			virtual void catchUp() = 0;  // Run everything up to the current clock, excluded
+	};
 }
 
 #endif
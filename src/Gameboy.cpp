@@ -17,11 +17,27 @@ namespace toygb {
 		return delay;
 	}
 
+	// Same as waitFor, but actually sleeps instead of polling the clock
+	// This is less accurate, but in audio-synced mode the audio buffer absorbs the difference anyway
+	static inline int64_t sleepFor(clocktime_t start, int64_t nanoseconds) {
+		std::this_thread::sleep_until(start + std::chrono::nanoseconds(nanoseconds));
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+	}
+
 	// Initialize the emulator
 	Gameboy::Gameboy(GameboyConfig& config):
 		m_config(config), m_cpu(config), m_lcd(),
 		m_interrupt(), m_audio(), m_cart(), m_serial(), m_dma(),
 		m_hardware(config.mode, config.console, config.system) {
+		m_interface = nullptr;
+		m_audioWriter = nullptr;
+	}
+
+	Gameboy::~Gameboy() {
+		if (m_interface != nullptr) delete m_interface;
+		m_interface = nullptr;
+		if (m_audioWriter != nullptr) delete m_audioWriter;
+		m_audioWriter = nullptr;
 	}
 
 	// Start the emulator
@@ -58,7 +74,8 @@ namespace toygb {
 
 		m_interrupt.init();
 		m_hardware.init(&m_interrupt);
-		m_lcd.init(&m_hardware, &m_interrupt);
+		m_lcd.init(&m_hardware, &m_interrupt, Interface::PIXEL_FORMAT);
+		m_lcd.setFrameSkip(m_config.frameSkip);
 		m_audio.init(&m_hardware);
 		m_joypad.init(&m_hardware, &m_interrupt);
 		m_serial.init(&m_hardware, &m_interrupt);
@@ -77,8 +94,18 @@ namespace toygb {
 		m_dma.configureMemory(&m_memory);
 		m_memory.build();
 
-		// Start the interface
-		std::thread uiThread(&runInterface, &m_interface, &m_lcd, &m_audio, &m_joypad);
+		// Start the interface, unless running headless (in which case we never open a window or an audio device)
+		std::thread uiThread;
+		if (!m_config.headless) {
+			m_interface = new Interface(m_config);
+			uiThread = std::thread(&runInterface, m_interface, &m_lcd, &m_audio, &m_joypad);
+		}
+
+		// The audio file output takes the place of the audio device, so it only runs headless
+		if (!m_config.audioFile.empty()) {
+			m_audioWriter = new AudioFileWriter(m_config.audioFile, &m_audio);
+			m_audioWriter->start();
+		}
 
 		// Start the clocked components
 		GBComponent cpuComponent = m_cpu.run(&m_memory, &m_dma);
@@ -87,50 +114,101 @@ namespace toygb {
 		uint64_t cycleCount = 0;
 #ifdef MONITOR_SPEED
 		int cycleDelay = 0;
+		uint64_t nextReport = 0x400000;
 		clocktime_t cycleStart = std::chrono::steady_clock::now();
 #endif
 
-		clocktime_t blockStart = std::chrono::steady_clock::now();
+		clocktime_t startTime = std::chrono::steady_clock::now();
+		clocktime_t blockStart = startTime;
 		int64_t inaccuracyReserve = 0;
-		while (!m_interface.isStopping()) {
+		double audioFill = 0;  // Smoothed fill level of the audio buffer, for audio-synced pacing
+		while (m_interface == nullptr || !m_interface->isStopping()) {
+			// Jump straight to the next clock where a component actually needs to run, the clocks in-between are no-ops for all of them
+			// This also covers HALT and STOP mode, where the CPU has nothing to do until the PPU or the timer request an interrupt
+			// In STOP mode, the joypad is only checked on those clocks, its state comes asynchronously from the interface anyway
+			// The CPU can not observe the APU, so its busy-wait loops only need to be interrupted by the other components (see CPU::detectIdleLoop)
+			int cpuHorizon = std::min({m_hardware.nextEvent(), m_dma.nextEvent(), m_lcd.nextEvent()});
+			int clocks = std::min({cpuHorizon, m_cpu.nextEvent(), m_audio.nextEvent()});
+
+			// Always stop on block boundaries (for pacing and run limits) and at the exact cycle limit
+			clocks = std::min(clocks, int(BLOCK_CYCLES - cycleCount % BLOCK_CYCLES));
+			if (m_config.maxCycles > 0)
+				clocks = int(std::min<uint64_t>(clocks, m_config.maxCycles - cycleCount));
+
+			if (clocks > 1) {
+				m_cpu.fastForward(clocks - 1);
+				m_lcd.fastForward(clocks - 1);
+				m_hardware.fastForward(clocks - 1);
+			}
+
 			// Run a clock cycle. FIXME : the order of the components here is dictated by emulator behaviour technicalities, is it significant ?
 			// Currently, CPU must be before DMA because of OAM DMA startup cycles handling
 			//            CPU must be before APU because that’s how we manage wave RAM access, but it could be done the other way by changing AudioWaveMapping::start
+			//            (the APU only catches up lazily, but an APU cycle that falls on the current clock is still run after the CPU, see AudioController::catchUp)
 			// The skip() methods here allow a little optimisation by not triggering a coroutine resume (context commutation) if it is useless (e.g the component is turned off)
 			m_hardware.update();
 			int sequencer = m_hardware.getSequencer();
 
 			if ((sequencer & 0b11) == 0 && !m_hardware.isStopped()) {
-				if (!m_cpu.skip())
+				if (!m_cpu.skip()) {
+					m_cpu.setEventHorizon(cpuHorizon - clocks);
 					cpuComponent.onCycle();
+				}
 				m_dma.runCycle();
 			}
 			// Exit STOP mode when a selected joypad button is pressed (when a bit goes low)
-			else if ((m_memory.get(IO_JOYPAD) & 0x0F) < 0x0F) {
+			else if (m_hardware.isStopped() && (m_memory.get(IO_JOYPAD) & 0x0F) < 0x0F) {
 				m_hardware.setStopMode(false);
 			}
 
-			// Keep the same timing for the APU and PPU, even in double-speed mode
+			// Keep the same timing for the PPU, even in double-speed mode (the APU works out its own timing from the timestamp)
 			if (!m_lcd.skip() && ((sequencer & 0b01) == 0 || !m_hardware.doubleSpeed()))
 				lcdComponent.onCycle();
-			if ((sequencer & (m_hardware.doubleSpeed() ? 0b11 : 0b01)) == 0)
-				m_audio.runCycle();
-
-			m_cart.update();
+			m_audio.update();
 
 			// Wait to skip excess time in-between cycles
 			// The timers are not accurate up to the nanosecond and it would be terribly inefficient to busy wait at each cycle for a few nanoseconds
 			// Thus we run cycles by "blocks", and "semi-busy wait" (see waitFor) during the excess time between each block
-			cycleCount += 1;
+			cycleCount += clocks;
+			if (m_config.maxCycles > 0 && cycleCount >= m_config.maxCycles)
+				break;
+
 			if (cycleCount % BLOCK_CYCLES == 0) {
+				// Frame and time limits do not need to be exact to the cycle, so only check them once per block
+				if (isBudgetReached(startTime))
+					break;
+
+				// Without pacing, the emulation can produce samples faster than they are written, wait for the writer instead of dropping them
+				if (m_audioWriter != nullptr)
+					m_audioWriter->throttle();
+			}
+
+			if (cycleCount % BLOCK_CYCLES == 0 && !m_config.uncapped) {
 				clocktime_t blockEnd = std::chrono::steady_clock::now();
 				int64_t blockNanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(blockEnd - blockStart).count();
 				blockStart = blockEnd;  // Must set this as soon as possible for better accuracy
 				int64_t expectedNanoseconds = int(BLOCK_CYCLES * (m_hardware.doubleSpeed() ? DOUBLESPEED_CLOCK_CYCLE_NS_REAL : CLOCK_CYCLE_NS_REAL));
 				inaccuracyReserve += expectedNanoseconds - blockNanoseconds;
+
+				// Audio-synced pacing : the audio output takes the samples at the pace of its own clock, that drifts away from the system clock
+				// The audio buffer fill level is the reference : when it runs low, the emulation runs ahead to fill it back (at startup or after a stall),
+				// otherwise its fill level nudges the output sample rate by a fraction of a percent to keep the latency constant (dynamic rate control)
+				if (m_config.audioSync) {
+					if (m_audio.bufferedSamples() < AUDIO_TARGET_LATENCY / 2)
+						inaccuracyReserve = 0;
+
+					if (cycleCount % (BLOCK_CYCLES * AUDIO_RATE_CONTROL_BLOCKS) == 0) {
+						// The output takes whole buffers at once, so only the average level over a few of them is significant
+						audioFill += (m_audio.bufferedSamples() - audioFill) / 64;
+						double error = std::clamp((AUDIO_TARGET_LATENCY - audioFill) / AUDIO_TARGET_LATENCY, -1.0, 1.0);
+						m_audio.setOutputRate(1.0 + AUDIO_MAX_RATE_DELTA * error);
+					}
+				}
+
 				// inaccuracyReserve is the current excess time, we only wait when it reaches a certain threshold for better efficiency
 				if (inaccuracyReserve >= MIN_WAIT_TIME_NS) {
-					int64_t actualDelay = waitFor(blockEnd, inaccuracyReserve);  // Give it blockEnd as a start to account for everything that happened since its measurement
+					// Give it blockEnd as a start to account for everything that happened since its measurement
+					int64_t actualDelay = (m_config.audioSync ? sleepFor(blockEnd, inaccuracyReserve) : waitFor(blockEnd, inaccuracyReserve));
 					blockStart = std::chrono::steady_clock::now();  // Set this as soon as possible
 #ifdef MONITOR_SPEED
 					cycleDelay += actualDelay;
@@ -140,18 +218,50 @@ namespace toygb {
 			}
 
 #ifdef MONITOR_SPEED
-			if (cycleCount % 0x400000 == 0) {
+			if (cycleCount >= nextReport) {
 				clocktime_t cycleEnd = std::chrono::steady_clock::now();
 				double duration = std::chrono::duration_cast<std::chrono::microseconds>(cycleEnd - cycleStart).count() / 1000000.0;
-				std::cout << 0x400000 << " cycles in " << duration << " seconds : " << 100.0 / duration << "% (" << int(0x400000 / duration) << " Hz), " << cycleDelay / 1000000000.0 << "s of delays (" << cycleDelay / (duration*10000000.0) << "%)" << std::endl;
+				std::cout << 0x400000 << " cycles in " << duration << " seconds : " << 100.0 / duration << "% (" << int(0x400000 / duration) << " Hz), " << cycleDelay / 1000000000.0 << "s of delays (" << cycleDelay / (duration*10000000.0) << "%), audio : " << m_audio.underruns() << " underruns, " << m_audio.overruns() << " overruns" << std::endl;
 				cycleStart = cycleEnd;
 				cycleDelay = 0.0;
+				nextReport += 0x400000;
 			}
 #endif
 		}
 
-		uiThread.join();
-		m_cart.save();  // TODO : Currently only saves at exit, add autosaves in case of crash or whatever ?
+		// Report the global emulation speed when running without real-time pacing
+		if (m_config.uncapped) {
+			double duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count() / 1000000.0;
+			std::cout << cycleCount << " cycles (" << m_lcd.frameCount() << " frames) in " << duration << " seconds : " << 100.0 * cycleCount / (CLOCK_FREQUENCY * duration) << "% (" << uint64_t(cycleCount / duration) << " Hz)" << std::endl;
+			std::cout << m_cpu.instructionCount() << " instructions executed : " << uint64_t(m_cpu.instructionCount() / duration) << " instructions per second" << std::endl;
+			std::cout << m_cpu.idleLoopHits() << " busy-wait loops skipped : " << m_cpu.idleLoopCycles() << " CPU cycles" << std::endl;
+		}
+
+		// Write the samples up to the last clock that was run, and finish the audio file
+		if (m_audioWriter != nullptr) {
+			m_audio.catchUp();
+			m_audioWriter->stop();
+			std::cout << m_audioWriter->framesWritten() << " audio frames written to " << m_config.audioFile << std::endl;
+		}
+
+		// Close the interface if the emulation was stopped by a run limit
+		if (m_interface != nullptr) {
+			m_interface->stop();
+			uiThread.join();
+		}
+		m_cart.save();  // TODO : Currently only saves at exit, add autosaves in case of crash or whatever ?
+	}
+
+	// Tell whether the frame or time limits set in the config have been reached
+	bool Gameboy::isBudgetReached(clocktime_t startTime) {
+		if (m_config.maxFrames > 0 && m_lcd.frameCount() >= m_config.maxFrames)
+			return true;
+		if (m_config.maxTime > 0) {
+			double elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count() / 1000000.0;
+			if (elapsed >= m_config.maxTime)
+				return true;
+		}
+		return false;
 	}
 
 	void runInterface(Interface* interface, LCDController* lcd, AudioController* audio, JoypadController* joypad) {
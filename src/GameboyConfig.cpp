@@ -13,6 +13,17 @@ namespace toygb {
 
 		disassemble = false;
 
+		headless = false;
+		uncapped = false;
+		audioSync = false;
+		maxFrames = 0;
+		maxCycles = 0;
+		maxTime = 0;
+		frameSkip = 1;
+		audioFile = "";
+
+		smoothScaling = false;
+
 		defaultBootDMG0 = "boot/toyboot_dmg0.bin";
 		defaultBootDMG = "boot/toyboot_dmg.bin";
 		defaultBootMGB = "boot/toyboot_mgb.bin";
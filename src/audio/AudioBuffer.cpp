@@ -0,0 +1,84 @@
+#include "audio/AudioBuffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+/** Audio output buffer
+The APU produces samples at the pace of the emulation, while the audio output takes them in large chunks from its own thread.
+The frames go through a ring buffer where each index is only written by one side : the producer publishes the frames it has written
+by moving the write index, and the consumer releases the space it has read by moving the read index, so no lock is ever needed. */
+
+
+namespace toygb {
+	AudioBuffer::AudioBuffer() {
+		m_frames = new int16_t[2 * AUDIO_BUFFER_FRAMES];
+		m_lastFrame[0] = m_lastFrame[1] = 0;
+		m_writeIndex = 0;
+		m_readIndex = 0;
+		m_underruns = 0;
+		m_overruns = 0;
+	}
+
+	AudioBuffer::~AudioBuffer() {
+		if (m_frames != nullptr) delete[] m_frames;
+	}
+
+	// Add several frames at the end of the buffer, from the emulation thread
+	void AudioBuffer::push(const int16_t* frames, int count) {
+		uint32_t writeIndex = m_writeIndex.load(std::memory_order_relaxed);
+		int space = AUDIO_BUFFER_FRAMES - int(writeIndex - m_readIndex.load(std::memory_order_acquire));
+		int written = std::min(space, count);
+		if (written < count)
+			m_overruns.store(m_overruns.load(std::memory_order_relaxed) + (count - written), std::memory_order_relaxed);
+
+		// The frames may wrap around the end of the buffer
+		int position = writeIndex % AUDIO_BUFFER_FRAMES;
+		int firstPart = std::min(written, AUDIO_BUFFER_FRAMES - position);
+		std::memcpy(m_frames + 2 * position, frames, 2 * firstPart * sizeof(int16_t));
+		std::memcpy(m_frames, frames + 2 * firstPart, 2 * (written - firstPart) * sizeof(int16_t));
+		m_writeIndex.store(writeIndex + written, std::memory_order_release);
+	}
+
+	// Read frames from the start of the buffer, from the audio thread
+	int AudioBuffer::read(int16_t* frames, int count) {
+		uint32_t readIndex = m_readIndex.load(std::memory_order_relaxed);
+		int available = int(m_writeIndex.load(std::memory_order_acquire) - readIndex);
+		int taken = std::min(available, count);
+
+		// The frames may wrap around the end of the buffer
+		int position = readIndex % AUDIO_BUFFER_FRAMES;
+		int firstPart = std::min(taken, AUDIO_BUFFER_FRAMES - position);
+		std::memcpy(frames, m_frames + 2 * position, 2 * firstPart * sizeof(int16_t));
+		std::memcpy(frames + 2 * firstPart, m_frames, 2 * (taken - firstPart) * sizeof(int16_t));
+		m_readIndex.store(readIndex + taken, std::memory_order_release);
+
+		if (taken > 0) {
+			m_lastFrame[0] = frames[2 * taken - 2];
+			m_lastFrame[1] = frames[2 * taken - 1];
+		}
+
+		// Not enough frames : hold the last value rather than dropping to silence, that would make an audible click
+		if (taken < count) {
+			for (int i = taken; i < count; i++) {
+				frames[2 * i] = m_lastFrame[0];
+				frames[2 * i + 1] = m_lastFrame[1];
+			}
+			m_underruns.store(m_underruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		}
+		return taken;
+	}
+
+	// Get the amount of frames in the buffer, it can only grow from the producer side and only shrink from the consumer side
+	int AudioBuffer::available() const {
+		uint32_t readIndex = m_readIndex.load(std::memory_order_acquire);
+		return int(m_writeIndex.load(std::memory_order_acquire) - readIndex);
+	}
+
+	uint64_t AudioBuffer::underruns() const {
+		return m_underruns.load(std::memory_order_relaxed);
+	}
+
+	uint64_t AudioBuffer::overruns() const {
+		return m_overruns.load(std::memory_order_relaxed);
+	}
+}
@@ -1,12 +1,20 @@
 #include "audio/AudioController.hpp"
 
+#include <algorithm>
+
+/** Audio processing unit timing
+The APU runs at 2MHz regardless of the speed mode, APU cycle n happens at timestamp 4n (see HardwareStatus::getTimestamp), after the CPU on the same clock.
+Nothing in the APU interrupts the CPU, so instead of running it on every cycle, it is only brought up to date when something may observe its state :
+when a register is accessed (see AudioSyncMapping), right before the divider or the speed mode change (see LazyComponent), and periodically to feed the audio output.
+Between those, the channels run whole stretches of cycles at once between two frame sequencer clocks, and tell the mixer at which cycle their output changes. */
+
 #define CHANNEL_TONE_SWEEP 0
 #define CHANNEL_TONE 1
 #define CHANNEL_WAVE 2
 #define CHANNEL_NOISE 3
 
-#define SAMPLE_LOW (-2000)
-#define SAMPLE_HIGH (2000)
+// Amplitude of a channel output at full volume, in output sample units
+#define CHANNEL_AMPLITUDE 2400
 
 
 namespace toygb {
@@ -14,92 +22,184 @@ namespace toygb {
 	AudioController::AudioController() {
 		for (int i = 0; i < 4; i++)
 			m_channels[i] = nullptr;
+		for (int i = 0; i < 7; i++)
+			m_syncMappings[i] = nullptr;
 		m_control = nullptr;
+		m_debug = nullptr;
 		m_wavePatternMapping = nullptr;
 		m_wavePattern = nullptr;
+		m_mixer = nullptr;
+		m_cycle = 0;
+		m_nextUpdate = 0;
+		m_previousDivider = 0;
 	}
 
 	AudioController::~AudioController() {
+		for (int i = 0; i < 7; i++){
+			if (m_syncMappings[i] != nullptr){
+				delete m_syncMappings[i];
+				m_syncMappings[i] = nullptr;
+			}
+		}
 		if (m_wavePattern != nullptr) delete[] m_wavePattern;
 		if (m_wavePatternMapping != nullptr) delete m_wavePatternMapping;
 		if (m_control != nullptr) delete m_control;
+		if (m_debug != nullptr) delete m_debug;
 		for (int i = 0; i < 4; i++){
 			if (m_channels[i]){
 				delete m_channels[i];
 				m_channels[i] = nullptr;
 			}
 		}
+		if (m_mixer != nullptr) delete m_mixer;
 	}
 
 	// Initialize the component
 	void AudioController::init(HardwareStatus* hardware) {
 		m_hardware = hardware;
 		m_wavePattern = new uint8_t[IO_WAVEPATTERN_SIZE];
+		m_mixer = new AudioMixer(&m_buffer, (m_hardware->console() == ConsoleModel::DMG || m_hardware->console() == ConsoleModel::SGB) ? DMG_CAPACITOR_CHARGE : CGB_CAPACITOR_CHARGE);
 
 		m_wavePatternMapping = new WaveMemoryMapping(m_wavePattern, m_hardware);
 		m_control = new AudioControlMapping(m_hardware);
 		m_debug = new AudioDebugMapping(m_hardware);
-		m_channels[0] = new AudioToneSweepMapping(0, m_control, m_debug, m_hardware);
-		m_channels[1] = new AudioToneMapping(1, m_control, m_debug, m_hardware);
-		m_channels[2] = new AudioWaveMapping(2, m_control, m_debug, m_wavePatternMapping, m_hardware);
-		m_channels[3] = new AudioNoiseMapping(3, m_control, m_debug, m_hardware);
+		m_channels[0] = new AudioToneSweepMapping(0, m_control, m_debug, m_mixer, m_hardware);
+		m_channels[1] = new AudioToneMapping(1, m_control, m_debug, m_mixer, m_hardware);
+		m_channels[2] = new AudioWaveMapping(2, m_control, m_debug, m_mixer, m_wavePatternMapping, m_hardware);
+		m_channels[3] = new AudioNoiseMapping(3, m_control, m_debug, m_mixer, m_hardware);
+
+		// All accesses from the CPU go through those, to catch up before them
+		for (int i = 0; i < 4; i++)
+			m_syncMappings[i] = new AudioSyncMapping(m_channels[i], this);
+		m_syncMappings[4] = new AudioSyncMapping(m_control, this, true);
+		m_syncMappings[5] = new AudioSyncMapping(m_wavePatternMapping, this);
+		m_syncMappings[6] = new AudioSyncMapping(m_debug, this);
+
+		m_cycle = m_hardware->getTimestamp() / 4 + 1;  // The clock at the current timestamp is already over
+		m_nextUpdate = 4 * (m_cycle + OUTPUT_UPDATE_PERIOD);
+		m_previousDivider = m_hardware->getDivider();
+		m_hardware->setLazyComponent(this);
+		updateVolumes();
+		updateOutputs();
 	}
 
 	// Configure the component's memory mappings
 	void AudioController::configureMemory(MemoryMap* memory) {
-		memory->add(IO_CH1_SWEEP, IO_CH1_CONTROL, m_channels[0]);
-		memory->add(IO_CH2_PATTERN, IO_CH2_CONTROL, m_channels[1]);
-		memory->add(IO_CH3_ENABLE, IO_CH3_CONTROL, m_channels[2]);
-		memory->add(IO_CH4_LENGTH, IO_CH4_CONTROL, m_channels[3]);
-		memory->add(IO_AUDIO_LEVELS, IO_AUDIO_ENABLE, m_control);
-		memory->add(IO_WAVEPATTERN_START, IO_WAVEPATTERN_END, m_wavePatternMapping);
-		memory->add(IO_UNDOCUMENTED_FF72, IO_PCM34, m_debug);
+		memory->add(IO_CH1_SWEEP, IO_CH1_CONTROL, m_syncMappings[0]);
+		memory->add(IO_CH2_PATTERN, IO_CH2_CONTROL, m_syncMappings[1]);
+		memory->add(IO_CH3_ENABLE, IO_CH3_CONTROL, m_syncMappings[2]);
+		memory->add(IO_CH4_LENGTH, IO_CH4_CONTROL, m_syncMappings[3]);
+		memory->add(IO_AUDIO_LEVELS, IO_AUDIO_ENABLE, m_syncMappings[4]);
+		memory->add(IO_WAVEPATTERN_START, IO_WAVEPATTERN_END, m_syncMappings[5]);
+		memory->add(IO_UNDOCUMENTED_FF72, IO_PCM34, m_syncMappings[6]);
 	}
 
-	// Run a single APU cycle (2MHz, regardless of double-speed mode)
-	void AudioController::runCycle() {
-		for (int index = 0; index < 4; index++) {  // Update each channel
-			AudioChannelMapping* channel = m_channels[index];
+	// Called on every clock that is run, catch up regularly so that the audio output gets its samples in time
+	void AudioController::update() {
+		if (m_hardware->getTimestamp() >= m_nextUpdate) {
+			catchUp();
+			m_nextUpdate = 4 * (m_cycle + OUTPUT_UPDATE_PERIOD);
+		}
+	}
+
+	// Tell in how many clocks the component needs to run
+	int AudioController::nextEvent() {
+		uint64_t timestamp = m_hardware->getTimestamp();
+		int clockDuration = (m_hardware->doubleSpeed() ? 1 : 2);  // Timestamp units per clock
+		if (m_nextUpdate <= timestamp)
+			return 1;
+		return int((m_nextUpdate - timestamp + clockDuration - 1) / clockDuration);
+	}
+
+	// Run all APU cycles before the current clock
+	void AudioController::catchUp() {
+		uint64_t timestamp = m_hardware->getTimestamp();
+		uint64_t target = (timestamp + 3) / 4;  // The APU cycle at the current timestamp comes after the CPU, so it is not run yet
+		if (m_cycle >= target)
+			return;
+
+		// The frame sequencer is clocked by bit 13 of the timer divider (bit 14 in double-speed mode)
+		// But in our case, as some timers need to be updated on 512Hz ticks instead of 256Hz and without any hardware tricks, we will use bits 12/13
+		// The speed mode and the divider can not have changed since the last catch-up, so the divider value at each past APU cycle is worked out from the current one
+		int triggerBit = (m_hardware->doubleSpeed() ? 13 : 12);
+		int clockDuration = (m_hardware->doubleSpeed() ? 1 : 2);  // Timestamp units per clock, the divider ticks on every clock
+		bool ticking = !m_hardware->isStopped();
+		uint16_t divider = m_hardware->getDivider();
+
+		while (m_cycle < target) {
+			// Divider ticks since the APU cycle, its value at that cycle is the one from the last clock at or before it
+			uint64_t ticks = (ticking ? (timestamp - 4*m_cycle + clockDuration - 1) / clockDuration : 0);
+			uint16_t cycleDivider = uint16_t(divider - ticks);
+			bool frameClock = (HIGH_TO_LOW(m_previousDivider, cycleDivider) >> triggerBit) & 1;
+
+			// Run all cycles up to the next frame sequencer clock, or up to the current clock
+			// Never more than OUTPUT_UPDATE_PERIOD cycles at once, as the mixer only holds the samples for that much
+			uint64_t end = std::min(target, m_cycle + OUTPUT_UPDATE_PERIOD);
+			if (ticking) {
+				uint64_t edgeTicks = (1 << (triggerBit + 1)) - (cycleDivider & ((1 << (triggerBit + 1)) - 1));  // Ticks until the next falling edge of the trigger bit
+				if (edgeTicks <= ticks) {
+					uint64_t edgeTimestamp = timestamp - (ticks - edgeTicks) * clockDuration;
+					end = std::min(end, (edgeTimestamp + 3) / 4);
+				}
+			}
+
 			if (m_control->audioEnable) {
-				if (!channel->powered)  // Enable set but not powered : audio controller just got powered on
-					channel->powerOn();
-				channel->update();
-			} else if (channel->powered) {  // Enable clear but powered : audio controller just got powered off
-				channel->powerOff();
+				for (int index = 0; index < 4; index++) {
+					if (frameClock)
+						m_channels[index]->clockFrameSequencer(m_cycle);
+					m_channels[index]->run(m_cycle, int(end - m_cycle));
+				}
 			}
+
+			m_previousDivider = uint16_t(divider - (ticking ? (timestamp - 4*(end - 1) + clockDuration - 1) / clockDuration : 0));
+			m_cycle = end;
+			m_mixer->flush(m_cycle);
 		}
 	}
 
-	// Get the mixed samples if available
-	bool AudioController::getSamples(int16_t* buffer) {
-		// Clear the sample buffer first
-		for (int i = 0; i < 2*OUTPUT_BUFFER_SAMPLES; i++)
-			buffer[i] = 0;
-
-		// The APU is powered off, so just return the buffer filled with zeros
-		if (!m_control->audioEnable)
-			return true;
-
-		// Get each channel’s buffer
-		float* channelBuffers[4];
-		for (int channel = 0; channel < 4; channel++) {
-			if ((channelBuffers[channel] = m_channels[channel]->getBuffer()) == nullptr)
-				return false;  // Channel returned nullptr -> not enough samples generated for the moment
-		}
+	// Apply the control register values to the channels power and output volumes
+	void AudioController::updateVolumes() {
+		for (int index = 0; index < 4; index++) {
+			AudioChannelMapping* channel = m_channels[index];
+			if (m_control->audioEnable && !channel->powered)  // Enable set but not powered : audio controller just got powered on
+				channel->powerOn();
+			else if (!m_control->audioEnable && channel->powered)  // Enable clear but powered : audio controller just got powered off
+				channel->powerOff();
 
-		// Mix samples
-		for (int channel = 0; channel < 4; channel++) {
-			for (int sample = 0; sample < OUTPUT_BUFFER_SAMPLES; sample++) {
-				// Output 2 is left, output 1 is right
-				//                 if output is enabled for the channel  : output volume               * sample value     / output level is in range 0-7 -> 8
-				float leftValue =  (m_control->output2Channels[channel]) ? (m_control->output2Level+1) * channelBuffers[channel][sample] / 8 : 0;
-				float rightValue = (m_control->output1Channels[channel]) ? (m_control->output1Level+1) * channelBuffers[channel][sample] / 8 : 0;
-
-				// Our output buffer has left first
-				buffer[2*sample] += int16_t(leftValue * 2400);
-				buffer[2*sample+1] += int16_t(rightValue * 2400);
-			}
+			// Output 2 is left, output 1 is right, the output levels in range 0-7 set the volume to (level+1)/8
+			// The output keeps going while the APU is powered off, with silence
+			int left = (m_control->audioEnable && m_control->output2Channels[index]) ? (m_control->output2Level + 1) * CHANNEL_AMPLITUDE / 8 : 0;
+			int right = (m_control->audioEnable && m_control->output1Channels[index]) ? (m_control->output1Level + 1) * CHANNEL_AMPLITUDE / 8 : 0;
+			m_mixer->setVolume(index, m_cycle, left, right);
 		}
-		return true;
+	}
+
+	// Apply the channel register values to their output levels
+	void AudioController::updateOutputs() {
+		for (int index = 0; index < 4; index++)
+			m_channels[index]->updateOutput(m_cycle);
+	}
+
+	// Get the mixed samples, this is the only method that may be called from the audio thread
+	bool AudioController::getSamples(int16_t* buffer) {
+		return m_buffer.read(buffer, OUTPUT_BUFFER_SAMPLES) == OUTPUT_BUFFER_SAMPLES;
+	}
+
+	// Change the output sample rate from the current clock on
+	void AudioController::setOutputRate(double factor) {
+		catchUp();
+		m_mixer->setRate(m_cycle, factor);
+	}
+
+	int AudioController::bufferedSamples() const {
+		return m_buffer.available();
+	}
+
+	uint64_t AudioController::underruns() const {
+		return m_buffer.underruns();
+	}
+
+	uint64_t AudioController::overruns() const {
+		return m_buffer.overruns();
 	}
 }
@@ -0,0 +1,155 @@
+#include "audio/AudioFileWriter.hpp"
+#include "util/error.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstring>
+
+/** Offline audio rendering
+The audio controller produces the samples into the same buffer whether they go to an audio device or a file, and the writer is just another consumer :
+it takes them whole output buffers at a time with AudioController::getSamples, gathers them into a much larger buffer, and writes it at once.
+All file accesses happen on the writer thread, so the emulation only has to wait for it when the audio buffer is about to fill up (see AudioFileWriter::throttle),
+which is what allows to render audio faster than real time without ever dropping a sample. */
+
+
+namespace toygb {
+	// Write an integer into a little-endian byte buffer
+	static void setLittleEndian(uint8_t* buffer, uint32_t value, int size) {
+		for (int i = 0; i < size; i++)
+			buffer[i] = uint8_t(value >> (8 * i));
+	}
+
+	// Open the output file, the WAV header is written with placeholder sizes until the end
+	AudioFileWriter::AudioFileWriter(std::string filename, AudioController* controller) {
+		m_filename = filename;
+		m_controller = controller;
+		m_running = false;
+		m_buffer = new int16_t[2 * AUDIO_FILE_BUFFER_FRAMES];
+		m_bufferedFrames = 0;
+		m_framesWritten = 0;
+
+		m_wave = filename.size() >= 4 && filename.compare(filename.size() - 4, 4, ".wav") == 0;
+		m_file.open(filename, std::ofstream::out | std::ofstream::binary | std::ofstream::trunc);
+		if (!m_file.is_open()) {
+			std::stringstream errstream;
+			errstream << "Audio output file " << filename << " could not be opened";
+			throw EmulationError(errstream.str());
+		}
+		if (m_wave)
+			writeHeader();
+	}
+
+	AudioFileWriter::~AudioFileWriter() {
+		if (m_thread.joinable()) {
+			m_running = false;
+			m_thread.join();
+		}
+		if (m_buffer != nullptr) delete[] m_buffer;
+	}
+
+	void AudioFileWriter::start() {
+		m_running = true;
+		m_thread = std::thread(&AudioFileWriter::run, this);
+	}
+
+	// Wait for the writer thread to make some space in the audio buffer
+	void AudioFileWriter::throttle() {
+		while (m_controller->bufferedSamples() > AUDIO_BUFFER_FRAMES - AUDIO_FILE_MIN_FREE_FRAMES)
+			std::this_thread::yield();
+	}
+
+	void AudioFileWriter::stop() {
+		if (m_thread.joinable()) {
+			m_running = false;
+			m_thread.join();
+		}
+
+		// Finish the file with the actual sizes in the WAV header
+		flush();
+		if (m_wave)
+			writeHeader();
+		m_file.close();
+		if (m_file.fail()) {
+			std::stringstream errstream;
+			errstream << "Could not write the audio output into " << m_filename;
+			throw EmulationError(errstream.str());
+		}
+	}
+
+	uint64_t AudioFileWriter::framesWritten() const {
+		return m_framesWritten;
+	}
+
+	// Writer thread main loop : take all whole output buffers as they come, then the remaining samples once the emulation has stopped
+	void AudioFileWriter::run() {
+		int16_t* samples = new int16_t[2 * OUTPUT_BUFFER_SAMPLES];
+		while (true) {
+			bool running = m_running;  // Must be read before checking the buffer, so that no samples are left behind after the emulation stops
+			if (m_controller->bufferedSamples() >= OUTPUT_BUFFER_SAMPLES) {
+				m_controller->getSamples(samples);
+				writeFrames(samples, OUTPUT_BUFFER_SAMPLES);
+			} else if (running) {
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			} else {
+				// getSamples() always fills a whole buffer, only the frames that were actually available are kept
+				int remaining = m_controller->bufferedSamples();
+				if (remaining > 0) {
+					m_controller->getSamples(samples);
+					writeFrames(samples, remaining);
+				}
+				break;
+			}
+		}
+		delete[] samples;
+	}
+
+	// Add frames to the file buffer, and write it when it is full
+	void AudioFileWriter::writeFrames(const int16_t* frames, int count) {
+		while (count > 0) {
+			int copied = std::min(count, AUDIO_FILE_BUFFER_FRAMES - m_bufferedFrames);
+			std::memcpy(m_buffer + 2 * m_bufferedFrames, frames, 2 * copied * sizeof(int16_t));
+			m_bufferedFrames += copied;
+			frames += 2 * copied;
+			count -= copied;
+			if (m_bufferedFrames == AUDIO_FILE_BUFFER_FRAMES)
+				flush();
+		}
+	}
+
+	// Write all buffered frames into the file
+	void AudioFileWriter::flush() {
+		if constexpr (std::endian::native == std::endian::big) {
+			for (int i = 0; i < 2 * m_bufferedFrames; i++)
+				m_buffer[i] = int16_t((uint16_t(m_buffer[i]) >> 8) | (uint16_t(m_buffer[i]) << 8));
+		}
+		m_file.write(reinterpret_cast<const char*>(m_buffer), 2 * m_bufferedFrames * sizeof(int16_t));
+		m_framesWritten += m_bufferedFrames;
+		m_bufferedFrames = 0;
+	}
+
+	// Write the WAV header at the beginning of the file, for the frames written so far
+	// The sizes are limited to 32 bits, beyond ~6 hours they are left at the maximum and most players read until the end of the file anyway
+	void AudioFileWriter::writeHeader() {
+		uint32_t dataSize = uint32_t(std::min<uint64_t>(m_framesWritten * 4, UINT32_MAX - 36));
+		uint8_t header[44];
+		std::memcpy(header, "RIFF", 4);
+		setLittleEndian(header + 4, 36 + dataSize, 4);
+		std::memcpy(header + 8, "WAVEfmt ", 8);
+		setLittleEndian(header + 16, 16, 4);                           // Format chunk size
+		setLittleEndian(header + 20, 1, 2);                            // PCM
+		setLittleEndian(header + 22, 2, 2);                            // Channels
+		setLittleEndian(header + 24, OUTPUT_SAMPLE_FREQUENCY, 4);      // Sample rate
+		setLittleEndian(header + 28, OUTPUT_SAMPLE_FREQUENCY * 4, 4);  // Bytes per second
+		setLittleEndian(header + 32, 4, 2);                            // Bytes per frame
+		setLittleEndian(header + 34, 16, 2);                           // Bits per sample
+		std::memcpy(header + 36, "data", 4);
+		setLittleEndian(header + 40, dataSize, 4);
+
+		std::streampos position = m_file.tellp();
+		m_file.seekp(0);
+		m_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+		if (position > 0)
+			m_file.seekp(position);
+	}
+}
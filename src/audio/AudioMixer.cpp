@@ -0,0 +1,288 @@
+#include "audio/AudioMixer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+	#include <immintrin.h>
+	#define X86_KERNELS
+#endif
+
+/** Band-limited audio synthesis
+The channel outputs are square waves that change on APU cycles, at 2MHz. Taking one sample out of ~43 at the output frequency aliases all their harmonics
+above 24kHz back into the audible range. Instead, each level change is added into the output as a step that is band-limited to the output frequency :
+the step is the integral of a windowed sinc impulse, so the impulse is added into a buffer of differences between consecutive samples, that is summed
+when the samples are complete. The impulse is precomputed for MIXER_KERNEL_PHASES positions of the change between two samples.
+Everything is in fixed point, and each impulse sums to exactly 1, so that the output gets back exactly to its level after any amount of changes.
+The differences are 32-bits and may wrap around, only their sum needs to fit.
+
+All four channels go into the same differences, so the mixing itself costs nothing : each channel only adds a step when its level or its volume
+changes, and the volumes are only computed again when NR50-NR52 are written (see AudioController::updateVolumes).
+The summed samples then go through a high-pass filter, like the capacitors on the hardware output that remove its DC offset.
+
+The output frequency is exactly OUTPUT_SAMPLE_FREQUENCY : an APU cycle is 3/128 of an output sample. The output is delayed by MIXER_KERNEL_TAPS/2 samples.
+The rate can be nudged to follow the actual pace of the audio output (see AudioController::setOutputRate), the position of the APU cycles in the output
+then goes on from the cycle of the change with the new step.
+
+Adding steps and completing samples are implemented with SSE2 on x86, compiled for it regardless of the build flags, and selected when it is available. */
+
+
+// Fixed point precision of the kernel and the accumulated samples
+#define KERNEL_SHIFT 15
+#define KERNEL_UNIT (1 << KERNEL_SHIFT)
+
+// Fixed point precision of the positions in the output, in output samples
+#define POSITION_SHIFT 24
+
+// Nominal output samples per APU cycle, in fixed point : OUTPUT_SAMPLE_FREQUENCY / APU_CLOCK_FREQUENCY = 3 / 128
+#define NOMINAL_STEP ((uint64_t(3) << POSITION_SHIFT) >> 7)
+
+// Cutoff of the band-limited steps, relative to the output frequency (0.5 = Nyquist frequency)
+#define KERNEL_CUTOFF 0.45
+
+
+namespace toygb {
+	// Impulse kernels for each phase, in fixed point. Tap k is added to the difference at (sample of the change + k)
+	static int16_t s_kernel[MIXER_KERNEL_PHASES][MIXER_KERNEL_TAPS];
+	// Same, with each tap as (tap, 0, 0, tap) to multiply (left, right, left, right) into (left * tap, right * tap)
+	alignas(16) static int16_t s_kernelPairs[MIXER_KERNEL_PHASES][MIXER_KERNEL_TAPS * 4];
+	static bool s_kernelBuilt = false;
+
+	// Compute the windowed sinc impulse for each phase
+	static void buildKernel() {
+		const double pi = 3.14159265358979323846;
+		const double halfWidth = MIXER_KERNEL_TAPS / 2;
+		for (int phase = 0; phase < MIXER_KERNEL_PHASES; phase++) {
+			double offset = (phase + 0.5) / MIXER_KERNEL_PHASES;  // Position of the change after the sample
+
+			double values[MIXER_KERNEL_TAPS];
+			double sum = 0;
+			for (int tap = 0; tap < MIXER_KERNEL_TAPS; tap++) {
+				double x = tap - halfWidth - offset + 1;  // Distance from the change, centered in the kernel
+				double sinc = (x == 0 ? 1 : std::sin(2 * pi * KERNEL_CUTOFF * x) / (2 * pi * KERNEL_CUTOFF * x));
+				double window = 0.42 + 0.5 * std::cos(pi * x / halfWidth) + 0.08 * std::cos(2 * pi * x / halfWidth);  // Blackman window
+				values[tap] = sinc * std::max(window, 0.0);
+				sum += values[tap];
+			}
+
+			// Normalize, and put the rounding error on the largest tap so that the whole impulse is exactly 1
+			int total = 0, largest = 0;
+			for (int tap = 0; tap < MIXER_KERNEL_TAPS; tap++) {
+				s_kernel[phase][tap] = int16_t(std::lround(values[tap] / sum * KERNEL_UNIT));
+				total += s_kernel[phase][tap];
+				if (s_kernel[phase][tap] > s_kernel[phase][largest])
+					largest = tap;
+			}
+			s_kernel[phase][largest] += KERNEL_UNIT - total;
+
+			for (int tap = 0; tap < MIXER_KERNEL_TAPS; tap++) {
+				s_kernelPairs[phase][tap * 4] = s_kernelPairs[phase][tap * 4 + 3] = s_kernel[phase][tap];
+				s_kernelPairs[phase][tap * 4 + 1] = s_kernelPairs[phase][tap * 4 + 2] = 0;
+			}
+		}
+		s_kernelBuilt = true;
+	}
+
+
+	////////// Portable implementations
+
+	// Add a step of the given heights (in range [-32768, 32767]) to the interleaved left and right differences
+	static void addStepScalar(int32_t* deltas, int phase, int left, int right) {
+		const int16_t* kernel = s_kernel[phase];
+		for (int tap = 0; tap < MIXER_KERNEL_TAPS; tap++) {
+			deltas[2 * tap] = int32_t(uint32_t(deltas[2 * tap]) + uint32_t(left * kernel[tap]));
+			deltas[2 * tap + 1] = int32_t(uint32_t(deltas[2 * tap + 1]) + uint32_t(right * kernel[tap]));
+		}
+	}
+
+	// Sum `count` interleaved differences into samples, filter them and convert them to PCM16
+	static void mixSamplesScalar(const int32_t* deltas, int count, int32_t* accumulators, float* capacitors, float charge, int16_t* output) {
+		for (int i = 0; i < count; i++) {
+			for (int side = 0; side < 2; side++) {
+				accumulators[side] = int32_t(uint32_t(accumulators[side]) + uint32_t(deltas[2 * i + side]));
+
+				// The capacitor slowly charges to the input level through the difference that goes to the output
+				float level = float(accumulators[side]) * (1.0f / KERNEL_UNIT);
+				float value = level - capacitors[side];
+				capacitors[side] = level - value * charge;
+				output[2 * i + side] = int16_t(std::clamp(std::lrint(value), -32768L, 32767L));
+			}
+		}
+	}
+
+#ifdef X86_KERNELS
+	////////// SSE2 implementations
+
+	__attribute__((target("sse2")))
+	static void addStepSSE2(int32_t* deltas, int phase, int left, int right) {
+		const __m128i* kernel = reinterpret_cast<const __m128i*>(s_kernelPairs[phase]);
+		__m128i heights = _mm_set1_epi32(int((uint32_t(uint16_t(right)) << 16) | uint16_t(left)));  // (left, right) in every pair of 16-bits lanes
+		for (int tap = 0; tap < MIXER_KERNEL_TAPS; tap += 2) {
+			// 2 taps at once : (tap0, 0, 0, tap0, tap1, 0, 0, tap1) * (left, right, ...) -> (left * tap0, right * tap0, left * tap1, right * tap1)
+			__m128i* target = reinterpret_cast<__m128i*>(deltas + 2 * tap);
+			__m128i products = _mm_madd_epi16(_mm_load_si128(kernel + tap / 2), heights);
+			_mm_storeu_si128(target, _mm_add_epi32(_mm_loadu_si128(target), products));
+		}
+	}
+
+	__attribute__((target("sse2")))
+	static void mixSamplesSSE2(const int32_t* deltas, int count, int32_t* accumulators, float* capacitors, float charge, int16_t* output) {
+		__m128i accumulator = _mm_set_epi32(accumulators[1], accumulators[0], accumulators[1], accumulators[0]);
+		__m128 capacitor = _mm_setr_ps(capacitors[0], capacitors[1], 0, 0);
+		__m128 charges = _mm_set1_ps(charge);
+		__m128 scale = _mm_set1_ps(1.0f / KERNEL_UNIT);
+
+		// 4 frames at a time, as 2 pairs of (left, right) frames
+		int i = 0;
+		for (; i + 4 <= count; i += 4) {
+			__m128i values[2];
+			for (int pair = 0; pair < 2; pair++) {
+				// Sum the differences : (dl0, dr0, dl1, dr1) -> (l + dl0, r + dr0, l + dl0 + dl1, r + dr0 + dr1)
+				__m128i differences = _mm_loadu_si128(reinterpret_cast<const __m128i*>(deltas + 2 * i + 4 * pair));
+				differences = _mm_add_epi32(differences, _mm_slli_si128(differences, 8));
+				__m128i levels = _mm_add_epi32(accumulator, differences);
+				accumulator = _mm_shuffle_epi32(levels, _MM_SHUFFLE(3, 2, 3, 2));
+
+				// The filter depends on the previous frame, so it goes one frame after the other, with left and right side by side
+				__m128 level = _mm_mul_ps(_mm_cvtepi32_ps(levels), scale);
+				__m128 value0 = _mm_sub_ps(level, capacitor);
+				capacitor = _mm_sub_ps(level, _mm_mul_ps(value0, charges));
+				__m128 level1 = _mm_movehl_ps(level, level);
+				__m128 value1 = _mm_sub_ps(level1, capacitor);
+				capacitor = _mm_sub_ps(level1, _mm_mul_ps(value1, charges));
+				values[pair] = _mm_cvtps_epi32(_mm_movelh_ps(value0, value1));
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(output + 2 * i), _mm_packs_epi32(values[0], values[1]));  // Saturates to 16 bits
+		}
+
+		accumulators[0] = _mm_cvtsi128_si32(accumulator);
+		accumulators[1] = _mm_cvtsi128_si32(_mm_shuffle_epi32(accumulator, _MM_SHUFFLE(1, 1, 1, 1)));
+		float remaining[4];
+		_mm_storeu_ps(remaining, capacitor);
+		capacitors[0] = remaining[0];
+		capacitors[1] = remaining[1];
+		mixSamplesScalar(deltas + 2 * i, count - i, accumulators, capacitors, charge, output + 2 * i);
+	}
+#endif
+
+	////////// Runtime selection
+
+	static void (*s_addStep)(int32_t*, int, int, int) = addStepScalar;
+	static void (*s_mixSamples)(const int32_t*, int, int32_t*, float*, float, int16_t*) = mixSamplesScalar;
+
+	// Select the SSE2 implementations if the host CPU supports them
+	static void selectKernels() {
+		s_addStep = addStepScalar;
+		s_mixSamples = mixSamplesScalar;
+		#ifdef X86_KERNELS
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("sse2")) {
+				s_addStep = addStepSSE2;
+				s_mixSamples = mixSamplesSSE2;
+			}
+		#endif
+	}
+
+
+	AudioMixer::AudioMixer(AudioBuffer* output, double capacitorCharge) {
+		if (!s_kernelBuilt) {
+			buildKernel();
+			selectKernels();
+		}
+
+		m_output = output;
+		for (int channel = 0; channel < 4; channel++) {
+			m_levels[channel] = 0;
+			m_volumes[channel][0] = m_volumes[channel][1] = 0;
+			m_contributions[channel][0] = m_contributions[channel][1] = 0;
+		}
+
+		m_deltas = new int32_t[2 * MIXER_BUFFER_SAMPLES];
+		std::memset(m_deltas, 0, 2 * MIXER_BUFFER_SAMPLES * sizeof(int32_t));
+		m_samples = new int16_t[2 * MIXER_BUFFER_SAMPLES];
+		m_nextSample = 0;
+		m_accumulators[0] = m_accumulators[1] = 0;
+		m_capacitors[0] = m_capacitors[1] = 0;
+		m_charge = float(std::pow(capacitorCharge, double(CLOCK_FREQUENCY) / OUTPUT_SAMPLE_FREQUENCY));  // The factor is per clock, apply it for a whole sample
+
+		m_step = NOMINAL_STEP;
+		m_anchorCycle = 0;
+		m_anchorPosition = 0;
+	}
+
+	AudioMixer::~AudioMixer() {
+		if (m_deltas != nullptr) delete[] m_deltas;
+		if (m_samples != nullptr) delete[] m_samples;
+	}
+
+	void AudioMixer::usePortableKernels(bool portable) {
+		if (!s_kernelBuilt)
+			buildKernel();
+		selectKernels();
+		if (portable) {
+			s_addStep = addStepScalar;
+			s_mixSamples = mixSamplesScalar;
+		}
+	}
+
+	// Set the output level of a channel
+	void AudioMixer::setLevel(int channel, uint64_t cycle, float level) {
+		if (level != m_levels[channel]) {
+			m_levels[channel] = level;
+			updateChannel(channel, cycle);
+		}
+	}
+
+	// Set the output volumes of a channel
+	void AudioMixer::setVolume(int channel, uint64_t cycle, int left, int right) {
+		if (left != m_volumes[channel][0] || right != m_volumes[channel][1]) {
+			m_volumes[channel][0] = left;
+			m_volumes[channel][1] = right;
+			updateChannel(channel, cycle);
+		}
+	}
+
+	// Change the amount of output samples per APU cycle
+	// Nothing may be added before that cycle anymore, so the positions of the previous cycles do not matter
+	void AudioMixer::setRate(uint64_t cycle, double factor) {
+		m_anchorPosition = position(cycle);
+		m_anchorCycle = cycle;
+		m_step = uint64_t(std::llround(NOMINAL_STEP * factor));
+	}
+
+	// Get the position of the beginning of an APU cycle in the output, in fixed point samples
+	uint64_t AudioMixer::position(uint64_t cycle) const {
+		return m_anchorPosition + (cycle - m_anchorCycle) * m_step;
+	}
+
+	// Add a band-limited step for the change of value of a channel on the outputs
+	void AudioMixer::updateChannel(int channel, uint64_t cycle) {
+		int left = int(m_levels[channel] * m_volumes[channel][0]);
+		int right = int(m_levels[channel] * m_volumes[channel][1]);
+		if (left != m_contributions[channel][0] || right != m_contributions[channel][1]) {
+			uint64_t stepPosition = position(cycle);
+			int sample = int((stepPosition >> POSITION_SHIFT) - m_nextSample);
+			int phase = int((stepPosition & ((uint64_t(1) << POSITION_SHIFT) - 1)) * MIXER_KERNEL_PHASES >> POSITION_SHIFT);
+			s_addStep(m_deltas + 2 * sample, phase, left - m_contributions[channel][0], right - m_contributions[channel][1]);
+
+			m_contributions[channel][0] = left;
+			m_contributions[channel][1] = right;
+		}
+	}
+
+	// Complete all samples that can not be affected by changes from the given cycle on
+	void AudioMixer::flush(uint64_t cycle) {
+		int count = int((position(cycle) >> POSITION_SHIFT) - m_nextSample);
+		if (count <= 0)
+			return;
+
+		s_mixSamples(m_deltas, count, m_accumulators, m_capacitors, m_charge, m_samples);
+		m_output->push(m_samples, count);
+
+		// Changes up to the given cycle may still affect the next MIXER_KERNEL_TAPS samples, move them back to the beginning of the buffer
+		std::memmove(m_deltas, m_deltas + 2 * count, 2 * MIXER_KERNEL_TAPS * sizeof(int32_t));
+		std::memset(m_deltas + 2 * MIXER_KERNEL_TAPS, 0, 2 * count * sizeof(int32_t));
+		m_nextSample += count;
+	}
+}
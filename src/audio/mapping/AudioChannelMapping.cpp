@@ -3,34 +3,18 @@
 
 namespace toygb {
 	// Initialize the base channel
-	AudioChannelMapping::AudioChannelMapping(int channel, AudioControlMapping* control, AudioDebugMapping* debug, HardwareStatus* hardware) {
+	AudioChannelMapping::AudioChannelMapping(int channel, AudioControlMapping* control, AudioDebugMapping* debug, AudioMixer* mixer, HardwareStatus* hardware) {
 		m_channel = channel;
 		m_control = control;
 		m_debug = debug;
+		m_mixer = mixer;
 		m_hardware = hardware;
 
 		m_started = false;  // Start disabled and powered on
 		powered = true;
 
-		m_backBuffer = new float[OUTPUT_BUFFER_SAMPLES];
-		m_outputBuffer = new float[OUTPUT_BUFFER_SAMPLES];
-		m_outputBufferIndex = 0;
-		m_bufferAvailable = false;
-
 		// Default values for the frame sequencer, not confirmed
 		m_frameSequencer = 7;
-		m_outputTimerCounter = 0;
-		m_previousDivider = m_hardware->getDivider();
-	}
-
-	// Get a full sample buffer, or nullptr if not full yed
-	float* AudioChannelMapping::getBuffer() {
-		if (m_bufferAvailable){
-			m_bufferAvailable = false;
-			return m_outputBuffer;
-		} else {
-			return nullptr;
-		}
 	}
 
 	// Enable channel operation, usually via NRx4.7
@@ -61,29 +45,17 @@ namespace toygb {
 		m_frameSequencer = 7;
 	}
 
-	// Called at every APU cycle
-	void AudioChannelMapping::update() {
-		// The frame sequencer is clocked by bit 13 of the timer divider (bit 14 in double-speed mode)
-		// But in our case, as some timers need to be updated on 512Hz ticks instead of 256Hz and without any hardware tricks, we will use bits 12/13
-		uint16_t divider = m_hardware->getDivider();
-		int triggerBit = (m_hardware->doubleSpeed() ? 13 : 12);
-		if ((HIGH_TO_LOW(m_previousDivider, divider) >> triggerBit) & 1) {
-			// Frame cycles in range 0-8
-			m_frameSequencer = (m_frameSequencer + 1) % 8;
-			if (m_frameSequencer >= 8)
-				m_frameSequencer = 0;
-			onFrame(m_frameSequencer);
-		}
-		m_previousDivider = divider;
-
-		// Audio output operation
-		m_outputTimerCounter += 1;
-		if (m_outputTimerCounter >= OUTPUT_SAMPLE_PERIOD) {
-			m_outputTimerCounter = 0;
-			outputSample();
-		}
-
-		onUpdate();
+	// Run several APU cycles at once
+	void AudioChannelMapping::run(uint64_t cycle, int cycles) {
+		onUpdate(cycle, cycles);
+	}
+
+	// Called when the frame sequencer clocks
+	// It is clocked by the falling edges of bit 12 of the timer divider (bit 13 in double-speed mode, see AudioController::catchUp)
+	void AudioChannelMapping::clockFrameSequencer(uint64_t cycle) {
+		m_frameSequencer = (m_frameSequencer + 1) % 8;
+		onFrame(m_frameSequencer);
+		updateOutput(cycle);
 	}
 
 	/** Called every time the frame sequencer clocks
@@ -129,19 +101,10 @@ namespace toygb {
 
 	}
 
-	// Output a sample to the audio output buffer
-	void AudioChannelMapping::outputSample() {
+	// Send the current output level to the mixer
+	void AudioChannelMapping::updateOutput(uint64_t cycle) {
 		float sample = (m_started ? buildSample() : 0);
-		m_backBuffer[m_outputBufferIndex] = sample;
 		m_debug->setChannelAmplitude(m_channel, uint8_t(((sample + 1.0f) / 2) * 0x0F));
-
-		// Swap the buffers once the back buffer is full
-		m_outputBufferIndex = (m_outputBufferIndex + 1) % OUTPUT_BUFFER_SAMPLES;
-		if (m_outputBufferIndex == 0){
-			float* tmp = m_backBuffer;
-			m_backBuffer = m_outputBuffer;
-			m_outputBuffer = tmp;
-			m_bufferAvailable = true;
-		}
+		m_mixer->setLevel(m_channel, cycle, sample);
 	}
 }
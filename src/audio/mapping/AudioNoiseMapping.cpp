@@ -30,7 +30,7 @@ namespace toygb {
 	const int NOISE_PERIOD_BASES[] = {4, 8, 16, 24, 32, 40, 48, 56};
 
 	// Initialize the channel.
-	AudioNoiseMapping::AudioNoiseMapping(int channel, AudioControlMapping* control, AudioDebugMapping* debug, HardwareStatus* hardware) : AudioChannelMapping(channel, control, debug, hardware) {
+	AudioNoiseMapping::AudioNoiseMapping(int channel, AudioControlMapping* control, AudioDebugMapping* debug, AudioMixer* mixer, HardwareStatus* hardware) : AudioChannelMapping(channel, control, debug, mixer, hardware) {
 		length = 0x3F;
 
 		initialEnvelopeVolume = 0;
@@ -108,17 +108,27 @@ namespace toygb {
 		}
 	}
 
-	// Called every APU cycle (= 2 clocks)
-	void AudioNoiseMapping::onUpdate() {
-		m_baseTimerCounter += 1;
+	// Run several APU cycles (= 2 clocks each)
+	void AudioNoiseMapping::onUpdate(uint64_t cycle, int cycles) {
 		// Period in APU cycles is NOISE_PERIOD_BASES[periodBase] << periodShift (*2 for clocks)
-		if (m_baseTimerCounter >= NOISE_PERIOD_BASES[periodBase] << periodShift) {
+		int period = NOISE_PERIOD_BASES[periodBase] << periodShift;
+		while (cycles > 0) {
+			int remaining = std::max(1, period - m_baseTimerCounter);  // Cycles until the next shift, included
+			if (remaining > cycles) {
+				m_baseTimerCounter += cycles;
+				break;
+			}
+
 			// Emulate linear feedback shift register behaviour : xor the lower 2 bits, shift everything right, and put the xor result as the higher bit (bit 14)
 			bool newBit = (m_register & 1) ^ ((m_register >> 1) & 1);
 			m_register = ((m_register >> 1) | (newBit << 14));
 			if (registerWidth)  // If NR43.3 is set, the xor result is also written in bit 6, so only the 7 lower bits are actually significant
 				m_register = (newBit << 6) | (m_register & 0b111111110111111);
 			m_baseTimerCounter = 0;
+
+			cycle += remaining;
+			cycles -= remaining;
+			updateOutput(cycle);
 		}
 	}
 
@@ -0,0 +1,35 @@
+#include "audio/mapping/AudioSyncMapping.hpp"
+#include "audio/AudioController.hpp"
+
+
+namespace toygb {
+	// Initialize the memory mapping
+	AudioSyncMapping::AudioSyncMapping(MemoryMapping* mapping, AudioController* controller, bool controlsVolumes) {
+		m_mapping = mapping;
+		m_controller = controller;
+		m_controlsVolumes = controlsVolumes;
+	}
+
+	// Get the value at the given relative address, as it is at the current clock
+	uint8_t AudioSyncMapping::get(uint16_t address) {
+		m_controller->catchUp();
+		return m_mapping->get(address);
+	}
+
+	// Set the value at the given relative address, and apply its effects on the output from the current clock on
+	void AudioSyncMapping::set(uint16_t address, uint8_t value) {
+		m_controller->catchUp();
+		m_mapping->set(address, value);
+		if (m_controlsVolumes)
+			m_controller->updateVolumes();
+		m_controller->updateOutputs();
+	}
+
+	void AudioSyncMapping::load(std::istream& input) {
+		m_mapping->load(input);
+	}
+
+	void AudioSyncMapping::save(std::ostream& output) {
+		m_mapping->save(output);
+	}
+}
@@ -31,7 +31,7 @@ namespace toygb {
 	const uint8_t TONE_WAVEPATTERNS[4] = {0b00000001, 0b10000001, 0b10000111, 0b01111110};
 
 	// Initialize the channel
-	AudioToneMapping::AudioToneMapping(int channel, AudioControlMapping* control, AudioDebugMapping* debug, HardwareStatus* hardware) : AudioChannelMapping(channel, control, debug, hardware) {
+	AudioToneMapping::AudioToneMapping(int channel, AudioControlMapping* control, AudioDebugMapping* debug, AudioMixer* mixer, HardwareStatus* hardware) : AudioChannelMapping(channel, control, debug, mixer, hardware) {
 		wavePatternDuty = 0;
 		length = 0x3F;
 
@@ -106,14 +106,24 @@ namespace toygb {
 		}
 	}
 
-	// Called at every APU cycle (= 2 clocks)
-	void AudioToneMapping::onUpdate() {
-		m_baseTimerCounter += 1;
-		// The update period in APU cycles 2*(2048 - `frequency`)
-		if (m_baseTimerCounter >= 2*(2048 - frequency)) {
+	// Run several APU cycles (= 2 clocks each)
+	void AudioToneMapping::onUpdate(uint64_t cycle, int cycles) {
+		// The timer counts every cycle, with a period in APU cycles of 2*(2048 - `frequency`)
+		int period = 2*(2048 - frequency);
+		while (cycles > 0) {
+			int remaining = std::max(1, period - m_baseTimerCounter);  // Cycles until the next duty step, included
+			if (remaining > cycles) {
+				m_baseTimerCounter += cycles;
+				break;
+			}
+
 			// Point to the next value of the selected pattern duty
 			m_dutyPointer = (m_dutyPointer + 1) % 8;
 			m_baseTimerCounter = 0;
+
+			cycle += remaining;
+			cycles -= remaining;
+			updateOutput(cycle);
 		}
 	}
 
@@ -35,7 +35,7 @@ namespace toygb {
 	const uint8_t TONE_WAVEPATTERNS[4] = {0b00000001, 0b10000001, 0b10000111, 0b01111110};
 
 	// Initialize the channel
-	AudioToneSweepMapping::AudioToneSweepMapping(int channel, AudioControlMapping* control, AudioDebugMapping* debug, HardwareStatus* hardware) : AudioChannelMapping(channel, control, debug, hardware) {
+	AudioToneSweepMapping::AudioToneSweepMapping(int channel, AudioControlMapping* control, AudioDebugMapping* debug, AudioMixer* mixer, HardwareStatus* hardware) : AudioChannelMapping(channel, control, debug, mixer, hardware) {
 		sweepPeriod = 0;
 		sweepDirection = false;
 		sweepShift = 0;
@@ -53,7 +53,6 @@ namespace toygb {
 		m_dutyPointer = 0;
 		m_envelopeVolume = initialEnvelopeVolume;
 		m_baseTimerCounter = 0;
-		m_outputTimerCounter = 0;
 		m_sweepFrequency = 0;
 		m_envelopeFrameCounter = 0;
 		m_sweepFrameCounter = 0;
@@ -131,13 +130,23 @@ namespace toygb {
 		}
 	}
 
-	// Called at every APU cycle (= 2 clocks)
+	// Run several APU cycles (= 2 clocks each)
 	// Period calculation is the same as channel 2, but using the calculated frequency with sweep
-	void AudioToneSweepMapping::onUpdate() {
-		m_baseTimerCounter += 1;
-		if (m_baseTimerCounter >= 2*(2048 - m_sweepFrequency)) {
+	void AudioToneSweepMapping::onUpdate(uint64_t cycle, int cycles) {
+		int period = 2*(2048 - m_sweepFrequency);
+		while (cycles > 0) {
+			int remaining = std::max(1, period - m_baseTimerCounter);  // Cycles until the next duty step, included
+			if (remaining > cycles) {
+				m_baseTimerCounter += cycles;
+				break;
+			}
+
 			m_dutyPointer = (m_dutyPointer + 1) % 8;
 			m_baseTimerCounter = 0;
+
+			cycle += remaining;
+			cycles -= remaining;
+			updateOutput(cycle);
 		}
 	}
 
@@ -246,7 +255,6 @@ namespace toygb {
 	// Called whe' the APU is powered on, reset the timers, sweep and wave duty position
 	void AudioToneSweepMapping::onPowerOn(){
 		m_dutyPointer = 0;
-		m_outputTimerCounter = 0;
 		m_baseTimerCounter = 0;
 		m_envelopeFrameCounter = 0;
 		m_sweepFrameCounter = 0;
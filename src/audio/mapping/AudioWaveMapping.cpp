@@ -26,7 +26,7 @@ namespace toygb {
 	const float WAVE_VOLUMES[] = {0.0f, 1.0f, 0.5f, 0.25f};
 
 	// Initialize the channel
-	AudioWaveMapping::AudioWaveMapping(int channel, AudioControlMapping* control, AudioDebugMapping* debug, WaveMemoryMapping* wavePatternMapping, HardwareStatus* hardware) : AudioChannelMapping(channel, control, debug, hardware) {
+	AudioWaveMapping::AudioWaveMapping(int channel, AudioControlMapping* control, AudioDebugMapping* debug, AudioMixer* mixer, WaveMemoryMapping* wavePatternMapping, HardwareStatus* hardware) : AudioChannelMapping(channel, control, debug, mixer, hardware) {
 		m_wavePatternMapping = wavePatternMapping;
 
 		enable = false;
@@ -95,18 +95,30 @@ namespace toygb {
 		}
 	}
 
-	// Called at every APU cycle (= 2 clocks)
-	void AudioWaveMapping::onUpdate() {
-		if (m_started){
-			m_baseTimerCounter -= 1;
-			if (m_baseTimerCounter <= 0){  // Update period is 2048 - frequency (not 2*(2048-frequency) like the others)
-				m_baseTimerCounter = 2048 - frequency;
-				m_sampleIndex = (m_sampleIndex + 1) % 32;  // Advance by one, cycling through the 32 samples
-				// Wave RAM access during channel operation depends on the sample being accessed. As our sample read and output is not related to the gameboy operation,
-				// we need to notify the wave RAM mapping specifically
-				m_wavePatternMapping->setCurrentIndex(m_sampleIndex >> 1);
+	// Run several APU cycles (= 2 clocks each)
+	void AudioWaveMapping::onUpdate(uint64_t cycle, int cycles) {
+		if (!m_started)
+			return;
+
+		while (cycles > 0) {
+			int remaining = std::max(1, m_baseTimerCounter);  // The timer counts down every cycle, cycles until the next sample included
+			if (remaining > cycles) {
+				m_baseTimerCounter -= cycles;
+				m_wavePatternMapping->update(cycles);  // Tell the wave RAM those APU cycles have passed (for wave RAM access during channel operation shenanigans)
+				break;
 			}
-			m_wavePatternMapping->update();  // Tell the wave RAM one APU cycle has passed (for wave RAM access during channel operation shenanigans)
+
+			m_wavePatternMapping->update(remaining - 1);
+			m_baseTimerCounter = 2048 - frequency;  // Update period is 2048 - frequency (not 2*(2048-frequency) like the others)
+			m_sampleIndex = (m_sampleIndex + 1) % 32;  // Advance by one, cycling through the 32 samples
+			// Wave RAM access during channel operation depends on the sample being accessed. As our sample read and output is not related to the gameboy operation,
+			// we need to notify the wave RAM mapping specifically
+			m_wavePatternMapping->setCurrentIndex(m_sampleIndex >> 1);
+			m_wavePatternMapping->update(1);
+
+			cycle += remaining;
+			cycles -= remaining;
+			updateOutput(cycle);
 		}
 	}
 
@@ -37,6 +37,16 @@ namespace toygb {
 		}
 	}
 
+	// No direct access, the accessible sample depends on the wave channel state, see ::get
+	uint8_t* WaveMemoryMapping::getReadPointer(uint16_t address) {
+		return nullptr;
+	}
+
+	// Same as for reads, see ::set
+	uint8_t* WaveMemoryMapping::getWritePointer(uint16_t address) {
+		return nullptr;
+	}
+
 	// Tell that the given index is being read
 	void WaveMemoryMapping::setCurrentIndex(uint16_t address) {
 		m_readIndex = address;
@@ -53,12 +63,12 @@ namespace toygb {
 		ArrayMemoryMapping::set(address, value);
 	}
 
-	// Called every APU cycle (= 2 cycles) while the wave channel is active
-	void WaveMemoryMapping::update() {
+	// Called with the APU cycles (= 2 clocks each) that have passed while the wave channel is active
+	void WaveMemoryMapping::update(int cycles) {
 		// Tick the timer for the currently read index access timer
 		// Wave RAM access is not disabled on CGB hardware
 		if (m_readIndex != WAVE_NOT_READABLE && !m_hardware->isCGBCapable()) {
-			m_readCounter -= 1;
+			m_readCounter -= cycles;
 			if (m_readCounter <= 0)
 				m_readIndex = WAVE_NOT_READABLE;
 		}
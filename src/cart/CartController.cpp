@@ -108,9 +108,4 @@ namespace toygb {
 	bool CartController::hasRTC() const {
 		return m_romMapping->hasRTC();
 	}
-
-	// Update the cartridge status
-	void CartController::update() {
-		m_romMapping->update();
-	}
 }
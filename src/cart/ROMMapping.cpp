@@ -8,6 +8,11 @@ namespace toygb {
 		m_cartType = carttype;
 		m_romFile = romfile;
 		m_ramFile = ramfile;
+
+		m_romData = nullptr;
+		m_ramData = nullptr;
+		m_fixedBank = nullptr;
+		m_switchableBank = nullptr;
 	}
 
 	ROMMapping::~ROMMapping() {
@@ -102,8 +107,28 @@ namespace toygb {
 		}
 	}
 
-	// Update the cartridge status, like the RTC
-	void ROMMapping::update() {
+	// Get the location of the given relative address within the currently mapped ROM banks
+	uint8_t* ROMMapping::getReadPointer(uint16_t address) {
+		if (address < ROM0_SIZE)
+			return m_fixedBank + address;
+		else
+			return m_switchableBank + (address - ROM0_SIZE);
+	}
 
+	// Map the given ROM banks, and only tell the memory map about the areas that actually changed
+	// Banks out of the actual ROM size wrap around, as the upper bank bits are not connected
+	void ROMMapping::mapROMBanks(int fixedBank, int switchableBank) {
+		int numBanks = m_romSize / ROM_BANK_SIZE;
+		uint8_t* fixedData = m_romData + (fixedBank % numBanks) * ROM_BANK_SIZE;
+		uint8_t* switchableData = m_romData + (switchableBank % numBanks) * ROM_BANK_SIZE;
+
+		if (fixedData != m_fixedBank) {
+			m_fixedBank = fixedData;
+			updateDirectAccess(ROM0_OFFSET, ROM1_OFFSET - 1);
+		}
+		if (switchableData != m_switchableBank) {
+			m_switchableBank = switchableData;
+			updateDirectAccess(ROM1_OFFSET, ROM1_OFFSET + ROM1_SIZE - 1);
+		}
 	}
 }
@@ -35,6 +35,7 @@ namespace toygb {
 		// If a rom bank greater than the amount of banks present in the cart is selected, the additional bits are masked out
 		// (This just builds the mask from the number of banks, for example 0b00101010 -> 0b00111111)
 		m_romBankMask = (1 << int(std::floor(std::log2(m_romBanks - 1) + 1))) - 1;
+		updateBanks();
 	}
 
 	MBC1CartMapping::~MBC1CartMapping() {
@@ -47,44 +48,57 @@ namespace toygb {
 	}
 
 	// Get the value at the given relative address (0 = first address of the mapping)
+	// The bank selection is done in MBC1CartMapping::updateBanks
 	uint8_t MBC1CartMapping::get(uint16_t address) {
-		// First ROM area
-		if (address < 0x4000) {
-			// Mode 1 : advanced banking mode : even base section is affected by the additional banking register,
-			//          so it may switch between 0x00, 0x20, 0x40, 0x60 depending on m_ramBankSelect
-			if (m_modeSelect) {
-				// Final bank = (m_ramBankSelect * 0x20 + 0x00), with excess bits masked out
-				return m_romData[address + ((m_ramBankSelect << 5) & m_romBankMask) * ROM_BANK_SIZE];
-			} else {  // Mode 0 : simple ROM banking : just get the value in bank 0
-				return m_romData[address];
-			}
-		// Switchable ROM area
-		} else {
-			// Final bank = (m_ramBankSelect * 0x20 + m_romBankSelect), with excess bits masked out
-			// case m_romBankSelect == 0 is handled in MBC1CartMapping::set
-			int bank = ((m_ramBankSelect << 5) | m_romBankSelect) & m_romBankMask;
-			return m_romData[(address - 0x4000) + bank * ROM_BANK_SIZE];
-		}
+		if (address < 0x4000)  // First ROM area
+			return m_fixedBank[address];
+		else  // Switchable ROM area
+			return m_switchableBank[address - 0x4000];
 	}
 
 	// Set the value at the given relative address
 	void MBC1CartMapping::set(uint16_t address, uint8_t value) {
 		// 0x0000 - 0x1FFF : RAM enable
 		if (address < 0x2000 && m_ramMapping != nullptr) {
-			m_ramMapping->accessible = ((value & 0x0F) == 0x0A);  // Lower 4 bits must be 0x0A
+			bool enable = ((value & 0x0F) == 0x0A);  // Lower 4 bits must be 0x0A
+			if (enable != m_ramMapping->accessible) {
+				m_ramMapping->accessible = enable;
+				m_ramMapping->updateDirectAccess();
+			}
 		}
 		// 0x2000 - 0x3FFF : switchable ROM bank select
 		else if (0x2000 <= address && address < 0x4000) {
 			m_romBankSelect = value;
 			if (m_romBankSelect == 0) m_romBankSelect = 1;  // Can’t map bank 0 to the switchable area, map 1 instead
+			updateBanks();
 		}
 		// 0x4000 - 0x5FFF : RAM bank select / upper ROM bank bits
 		else if (0x4000 <= address && address < 0x6000) {
 			m_ramBankSelect = value & 0x03;
+			updateBanks();
+			if (m_ramMapping != nullptr)
+				m_ramMapping->updateDirectAccess();
 		}
 		// 0x6000 - 0x7FFF : Banking mode select
 		else if (0x6000 <= address && address < 0x8000) {
 			m_modeSelect = value & 1;
+			updateBanks();
+			if (m_ramMapping != nullptr)
+				m_ramMapping->updateDirectAccess();
 		}
 	}
+
+	// Map the ROM banks selected by the current register values
+	void MBC1CartMapping::updateBanks() {
+		// Mode 1 : advanced banking mode : even base section is affected by the additional banking register,
+		//          so it may switch between 0x00, 0x20, 0x40, 0x60 depending on m_ramBankSelect
+		// Mode 0 : simple ROM banking : always bank 0
+		int fixedBank = (m_modeSelect ? ((m_ramBankSelect << 5) & m_romBankMask) : 0);
+
+		// Final bank = (m_ramBankSelect * 0x20 + m_romBankSelect), with excess bits masked out
+		// case m_romBankSelect == 0 is handled in MBC1CartMapping::set
+		int switchableBank = ((m_ramBankSelect << 5) | m_romBankSelect) & m_romBankMask;
+
+		mapROMBanks(fixedBank, switchableBank);
+	}
 }
@@ -30,4 +30,20 @@ namespace toygb {
 			}
 		}
 	}
+
+	// Get the location of the given relative address in the array, for direct accesses
+	// MBC1CartMapping calls updateDirectAccess() whenever the bank, mode or RAM enable registers change
+	uint8_t* MBC1RAMMapping::getReadPointer(uint16_t address) {
+		if (*m_modeSelect)  // Mode 1 : Banked RAM mode
+			return FullBankedMemoryMapping::getReadPointer(address);
+		else if (accessible && address < m_numBanks*m_bankSize)  // Mode 0 : Fixed RAM mode
+			return m_array + address;
+		else
+			return nullptr;
+	}
+
+	// Same as for reads
+	uint8_t* MBC1RAMMapping::getWritePointer(uint16_t address) {
+		return getReadPointer(address);
+	}
 }
@@ -4,7 +4,7 @@
 #define CARTTYPE_MBC2_BATTERY 0x06
 
 namespace toygb {
-	// TODO : Not implemented
+	// TODO : The built-in RAM is not implemented
 	MBC2CartMapping::MBC2CartMapping(uint8_t carttype, std::string romfile, std::string ramfile, HardwareStatus* hardware) : ROMMapping(carttype, romfile, ramfile, hardware) {
 		switch (carttype){
 			case CARTTYPE_MBC2: setCartFeatures(false, false, false); break;
@@ -13,6 +13,10 @@ namespace toygb {
 
 		loadCartData();
 
+		// Default values at boot
+		m_romBankSelect = 1;
+		mapROMBanks(0, m_romBankSelect);
+
 		if (m_ramData != nullptr) {
 			m_ramMapping = new ArrayMemoryMapping(m_ramData);
 			loadSaveData(m_ramMapping);
@@ -30,10 +34,18 @@ namespace toygb {
 	}
 
 	uint8_t MBC2CartMapping::get(uint16_t address) {
-		return m_romData[address];
+		if (address < 0x4000)  // Fixed bank area
+			return m_fixedBank[address];
+		else  // Switchable bank area
+			return m_switchableBank[address - 0x4000];
 	}
 
 	void MBC2CartMapping::set(uint16_t address, uint8_t value) {
-		// nop
+		// 0x0000 - 0x3FFF : ROM bank select when bit 8 of the address is set (otherwise RAM enable)
+		if (address < 0x4000 && (address & 0x0100)) {
+			m_romBankSelect = value & 0x0F;
+			if (m_romBankSelect == 0) m_romBankSelect = 1;  // Can’t select bank 0, select 1 instead
+			mapROMBanks(0, m_romBankSelect);
+		}
 	}
 }
@@ -6,13 +6,18 @@
 #define RTC_BANK_DAYS    0x0B
 #define RTC_BANK_CONTROL 0x0C
 
+// The RTC is clocked at 32768Hz, that is one tick every 256 emulated timestamp units (8388608Hz)
+#define RTC_TIMESTAMP_SHIFT 8
+
 
 namespace toygb {
 	// Initialize the memory mapping
-	MBC3RAMMapping::MBC3RAMMapping(uint8_t* bankSelect, int numBanks, uint16_t bankSize, uint8_t* array, bool allowAccess, MBC3RTC* rtc, MBC3RTC* rtcLatch) :
+	MBC3RAMMapping::MBC3RAMMapping(uint8_t* bankSelect, int numBanks, uint16_t bankSize, uint8_t* array, bool allowAccess, MBC3RTC* rtc, MBC3RTC* rtcLatch, HardwareStatus* hardware) :
 					FullBankedMemoryMapping(bankSelect, numBanks, bankSize, array, allowAccess) {
 		m_rtc = rtc;
 		m_rtcLatch = rtcLatch;
+		m_hardware = hardware;
+		m_rtcTimestamp = m_hardware->getTimestamp();
 	}
 
 	// Get the value at the given relative address
@@ -59,6 +64,7 @@ namespace toygb {
 				// FIXME : Does writing to the registers also update the latched values ?
 				// FIXME : What happens when writing to the registers without halting the clock ?
 				// FIXME : What happens when writing out-of-bounds values to a register (like a value >59 in the seconds)
+				updateRTC();
 				switch (*m_bankSelect) {
 					case RTC_BANK_SECONDS:
 						m_rtc->seconds = value;
@@ -92,8 +98,8 @@ namespace toygb {
 
 		// Read BESS-like RTC data at the end of the save file
 		if (m_rtc != nullptr) {
-			uint8_t seconds, minutes, hours, dayLow, control;
-			uint64_t saveTimestamp;
+			uint8_t seconds = 0, minutes = 0, hours = 0, dayLow = 0, control = 0;
+			uint64_t saveTimestamp = 0;  // Save files without RTC data leave the RTC at 0
 			input.read(reinterpret_cast<char*>(&seconds), 1);
 			input.seekg(3, std::istream::cur);
 			input.read(reinterpret_cast<char*>(&minutes), 1);
@@ -106,24 +112,25 @@ namespace toygb {
 			input.seekg(3, std::istream::cur);
 			input.read(reinterpret_cast<char*>(&saveTimestamp), 8);
 
-			int64_t currentSeconds, saveSeconds = 86400*(((control & 1) << 8) & dayLow) + 3600*hours + 60*minutes + seconds;
-			if ((control >> 6) & 1) {  // RTC halted, did not tick since last save
-				currentSeconds = saveSeconds;
-			} else {
+			m_rtc->divider = 0;  // TODO : save the 32768Hz divider status ?
+			m_rtc->seconds = seconds;
+			m_rtc->minutes = minutes;
+			m_rtc->hours = hours;
+			m_rtc->days = ((control & 1) << 8) | dayLow;
+			m_rtc->halt = (control >> 6) & 1;
+			m_rtc->dayCarry = (control >> 7) & 1;
+
+			// Catch up with the host time that passed since the save, unless the RTC was halted and did not tick
+			if (!m_rtc->halt && input) {
 				// Since C++20 system_clock has the UNIX epoch as standard
 				std::chrono::system_clock::duration unixTime = std::chrono::seconds(saveTimestamp);
 				std::chrono::time_point<std::chrono::system_clock> saveTime(unixTime);
 				std::chrono::time_point<std::chrono::system_clock> currentTime = std::chrono::system_clock::now();
-				currentSeconds = saveSeconds + std::chrono::duration_cast<std::chrono::seconds>(currentTime - saveTime).count();
+				int64_t elapsedSeconds = std::chrono::duration_cast<std::chrono::seconds>(currentTime - saveTime).count();
+				if (elapsedSeconds > 0)  // The host clock may have been set back in-between
+					advanceRTC(uint64_t(elapsedSeconds) << 15);
 			}
-
-			m_rtc->divider = 0;  // TODO : save the 32768Hz divider status ?
-			m_rtc->seconds = currentSeconds % 60;
-			m_rtc->minutes = (currentSeconds / 60) % 60;
-			m_rtc->hours = (currentSeconds / 3600) % 24;
-			m_rtc->days = (currentSeconds / 86400) % 512;
-			m_rtc->halt = (control >> 6) & 1;
-			m_rtc->dayCarry = (control >> 7) & 1;
+			m_rtcTimestamp = m_hardware->getTimestamp();
 		}
 	}
 
@@ -133,6 +140,7 @@ namespace toygb {
 
 		// Write BESS-like RTC data at the end of the save file
 		if (m_rtc != nullptr) {
+			updateRTC();
 			uint8_t threePaddingBytes[3] = {0, 0, 0};
 			int64_t timestamp = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch()).count();
 			uint8_t dayLow = m_rtc->days & 0xFF;
@@ -150,4 +158,39 @@ namespace toygb {
 			output.write(reinterpret_cast<char*>(&(timestamp)), 8);
 		}
 	}
+
+	// Apply the RTC ticks that happened in emulated time since the last update
+	// Here, while the emulator is running, the RTC is tied to the global Gameboy clock
+	// This is technically inaccurate as it is actually an independant 32768Hz oscillator located in the cartridge,
+	// but in that case using an external RTC (like the system clock) would be sensitive to software lag during emulation,
+	// leading to unwanted desynchronizations between the Gameboy and the RTC
+	// The registers only need to be up to date when they are latched, written or saved, so they are caught up all at once at that moment
+	void MBC3RAMMapping::updateRTC() {
+		uint64_t timestamp = m_hardware->getTimestamp();
+		if (!m_rtc->halt)
+			advanceRTC((timestamp >> RTC_TIMESTAMP_SHIFT) - (m_rtcTimestamp >> RTC_TIMESTAMP_SHIFT));
+		m_rtcTimestamp = timestamp;
+	}
+
+	// Advance the RTC registers, each register overflows into the next one in cascade
+	void MBC3RAMMapping::advanceRTC(uint64_t ticks) {
+		// Overflow into the seconds register every 32768 ticks at 32768Hz
+		uint64_t total = m_rtc->divider + ticks;
+		m_rtc->divider = total & 0x7FFF;
+		total = (total >> 15) + m_rtc->seconds;
+		if (total == m_rtc->seconds)
+			return;
+
+		m_rtc->seconds = total % 60;
+		total = total / 60 + m_rtc->minutes;
+		m_rtc->minutes = total % 60;
+		total = total / 60 + m_rtc->hours;
+		m_rtc->hours = total % 24;
+		total = total / 24 + m_rtc->days;
+		m_rtc->days = total % 512;
+
+		// When the days overflow, set the day carry
+		if (total >= 512)
+			m_rtc->dayCarry = 1;
+	}
 }
@@ -14,6 +14,7 @@ namespace toygb {
 		}
 
 		loadCartData();
+		mapROMBanks(0, 1);  // Not implemented, always the first two banks
 
 		if (m_ramData != nullptr) {
 			m_ramMapping = new ArrayMemoryMapping(m_ramData);
@@ -32,7 +33,10 @@ namespace toygb {
 	}
 
 	uint8_t MBC4CartMapping::get(uint16_t address) {
-		return m_romData[address];
+		if (address < 0x4000)
+			return m_fixedBank[address];
+		else
+			return m_switchableBank[address - 0x4000];
 	}
 
 	void MBC4CartMapping::set(uint16_t address, uint8_t value) {
@@ -27,6 +27,7 @@ namespace toygb {
 
 		m_romBanks = m_romSize / ROM_BANK_SIZE;
 		m_ramBanks = m_ramSize / SRAM_SIZE;
+		mapROMBanks(0, m_romBankSelect);
 
 		if (m_ramData != nullptr) {
 			m_ramMapping = new FullBankedMemoryMapping(&m_ramBankSelect, m_ramBanks, SRAM_SIZE, m_ramData, false);
@@ -47,28 +48,35 @@ namespace toygb {
 	uint8_t MBC5CartMapping::get(uint16_t address) {
 		// 0x0000-0x3FFF : Fixed bank area
 		if (address < 0x4000)
-			return m_romData[address];
+			return m_fixedBank[address];
 		// 0x4000-0x7FFF : Switchable bank area
 		else
-			return m_romData[(address - 0x4000) + m_romBankSelect * ROM_BANK_SIZE];
+			return m_switchableBank[address - 0x4000];
 	}
 
 	void MBC5CartMapping::set(uint16_t address, uint8_t value) {
 		// 0x0000-0x1FFF : RAM enable flag
 		if (address < 0x2000) {
-			m_ramMapping->accessible = ((value & 0x0F) == 0x0A);  // Lower 4 bits must be 0x0A to enable RAM
+			if (m_ramMapping != nullptr) {
+				m_ramMapping->accessible = ((value & 0x0F) == 0x0A);  // Lower 4 bits must be 0x0A to enable RAM
+				m_ramMapping->updateDirectAccess();
+			}
 		}
 		// 0x2000-0x2FFF : Lower byte of switchable ROM bank index
 		else if (0x2000 <= address && address < 0x3000) {
 			m_romBankSelect = (m_romBankSelect & 0x100) | value;
+			mapROMBanks(0, m_romBankSelect);
 		}
 		// 0x3000-0x3FFF : Upper bit of switchable ROM bank index
 		else if (0x3000 <= address && address < 0x4000) {
 			m_romBankSelect = (m_romBankSelect & 0x0FF) | ((value & 1) << 8);
+			mapROMBanks(0, m_romBankSelect);
 		}
 		// 0x4000-0x5FFF : RAM bank select
 		else if (0x4000 <= address && address < 0x6000) {
 			m_ramBankSelect = value & 0x0F;  // FIXME : check the index or just mask the excess bits out ?
+			if (m_ramMapping != nullptr)
+				m_ramMapping->updateDirectAccess();
 		}
 	}
 }
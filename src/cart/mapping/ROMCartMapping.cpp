@@ -14,6 +14,7 @@ namespace toygb {
 		}
 
 		loadCartData();
+		mapROMBanks(0, 1);  // No MBC, always the first two banks
 
 		if (m_ramData != nullptr) {
 			m_ramMapping = new ArrayMemoryMapping(m_ramData);
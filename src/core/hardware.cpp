@@ -10,10 +10,13 @@ namespace toygb {
 		m_hasBootrom = false;
 		m_bootromUnmapped = false;
 		m_doubleSpeed = false;
-		m_divider = 0x0000;
+		m_timestamp = 0;
+		m_timerClock = 0;
 		m_sequencer = 0x0000;
 		m_stopped = false;
 		m_speedSwitchCountdown = 0;
+		m_timerMapping = nullptr;
+		m_lazyComponent = nullptr;
 	}
 
 	// Initialize the hardware configuration with custom values
@@ -24,10 +27,13 @@ namespace toygb {
 		m_hasBootrom = false;
 		m_bootromUnmapped = false;
 		m_doubleSpeed = false;
-		m_divider = 0x0000;
+		m_timestamp = 0;
+		m_timerClock = 0;
 		m_sequencer = 0x0000;
 		m_stopped = false;
 		m_speedSwitchCountdown = 0;
+		m_timerMapping = nullptr;
+		m_lazyComponent = nullptr;
 	}
 
 	// Get the console model
@@ -97,11 +103,13 @@ namespace toygb {
 	void HardwareStatus::setDoubleSpeedMode(bool isDoubleSpeed) {
 		if (!isCGBCapable() && isDoubleSpeed)
 			throw EmulationError("Tried to set double-speed mode on non-CGB hardware");
+		catchUpLazyComponent();
 		m_doubleSpeed = isDoubleSpeed;
 	}
 
 	// Trigger a speed switch
 	void HardwareStatus::triggerSpeedSwitch() {
+		catchUpLazyComponent();
 		m_doubleSpeed = !m_doubleSpeed;
 		m_speedSwitchCountdown = 8200;  // The hardware is in transitory state for 8200 clocks
 	}
@@ -113,13 +121,26 @@ namespace toygb {
 
 	// Set whether the CPU is in STOP mode
 	void HardwareStatus::setStopMode(bool stop) {
+		catchUpLazyComponent();
 		m_stopped = stop;
 	}
 
 
 	// Initialize the component
 	void HardwareStatus::init(InterruptVector* interrupts) {
-		m_timerMapping = new TimerMapping(&m_divider, interrupts);
+		m_timerMapping = new TimerMapping(&m_timerClock, interrupts);
+	}
+
+	// Set the component that runs lazily from the clock (see LazyComponent)
+	void HardwareStatus::setLazyComponent(LazyComponent* component) {
+		m_lazyComponent = component;
+		m_timerMapping->setLazyComponent(component);
+	}
+
+	// Let the lazy component catch up before the clock state it depends on changes
+	void HardwareStatus::catchUpLazyComponent() {
+		if (m_lazyComponent != nullptr)
+			m_lazyComponent->catchUp();
 	}
 
 	// Configure the associated memory mappings
@@ -129,11 +150,40 @@ namespace toygb {
 
 	// Tick the clock and do appropriate actions
 	void HardwareStatus::update() {
+		if (m_speedSwitchCountdown == 1)  // The divider starts ticking again on this clock
+			catchUpLazyComponent();
+
 		m_sequencer += 1;
+		m_timestamp += (m_doubleSpeed ? 1 : 2);
 		if (m_speedSwitchCountdown > 0)
 			m_speedSwitchCountdown -= 1;
+		if (!isStopped()) {
+			m_timerClock += 1;
+			if (m_timerClock >= m_timerMapping->nextEvent())
+				m_timerMapping->update();
+		}
+	}
+
+	// Skip several clocks at once, the timer is evaluated lazily so nothing else needs to be done
+	void HardwareStatus::fastForward(int clocks) {
+		m_sequencer += clocks;
+		m_timestamp += uint64_t(m_doubleSpeed ? 1 : 2) * clocks;
 		if (!isStopped())
-			incrementDivider();
+			m_timerClock += clocks;
+		m_speedSwitchCountdown = std::max(0, m_speedSwitchCountdown - clocks);
+	}
+
+	// Get the amount of clocks until the timer needs to be updated, or until the end of the speed switch
+	int HardwareStatus::nextEvent() {
+		if (m_speedSwitchCountdown > 0)
+			return m_speedSwitchCountdown;
+		if (m_stopped)
+			return NO_EVENT;
+
+		uint64_t timerEvent = m_timerMapping->nextEvent();
+		if (timerEvent - m_timerClock >= NO_EVENT)
+			return NO_EVENT;
+		return timerEvent - m_timerClock;
 	}
 
 	// Get the emulator components sequence counter value
@@ -141,22 +191,19 @@ namespace toygb {
 		return m_sequencer;
 	}
 
-	// Get the current divider internal counter value
-	uint16_t HardwareStatus::getDivider() const {
-		return m_divider;
+	// Get the emulated time since startup
+	uint64_t HardwareStatus::getTimestamp() const {
+		return m_timestamp;
 	}
 
-	// Increment the internal divider counter and do the associated actions
-	void HardwareStatus::incrementDivider() {
-		uint16_t newValue = m_divider + 1;
-		m_timerMapping->dividerChange(newValue);
-		m_divider = newValue;
+	// Get the current divider internal counter value
+	uint16_t HardwareStatus::getDivider() const {
+		return m_timerMapping->divider();
 	}
 
 	// Reset the divider counter
 	void HardwareStatus::resetDivider() {
-		m_timerMapping->dividerChange(0);
-		m_divider = 0;
+		m_timerMapping->resetDivider();
 	}
 
 	// Set the remaining auto settings
@@ -14,6 +14,8 @@ The timer counter (register TIMA) increment frequency can be configured through
 However, it is not simply incremented every X clocks : TIMA increments are commanded through the internal counter.
 When a specific bit (set through that clock frequency parameter) goes from 1 to 0 in the internal counter value, TIMA gets incremented
 This detail has some importance in some obscure cases — for example, resetting the divider also impacts TIMA
+Here, nothing is done at each clock : the internal counter is derived from a clock timestamp, and TIMA is brought up to date
+only when it is accessed or when it is about to overflow (see TimerMapping::nextEvent), by counting the falling edges in-between
 When TIMA overflows, it is set to 0 for 4 clocks, then gets reset to the value of TMA. If TMA is set at the exact same cycle, the old value is transferred
 
 (Access is R for read-only, W for write-only, B for both, - for none)
@@ -37,9 +39,12 @@ namespace toygb {
 	const int TIMA_TRIGGER_BITS[] = {9, 3, 5, 7};
 
 	// Initialize the memory mapping with initial values
-	TimerMapping::TimerMapping(uint16_t* divider, InterruptVector* interrupt) {
-		m_divider = divider;
+	TimerMapping::TimerMapping(const uint64_t* clock, InterruptVector* interrupt) {
+		m_clock = clock;
 		m_interrupt = interrupt;
+		m_lazyComponent = nullptr;
+		m_dividerOrigin = *clock;
+		m_lastUpdate = *clock;
 
 		counter = 0x00;
 		modulo = 0x00;
@@ -51,9 +56,10 @@ namespace toygb {
 
 	// Get the value at the given relative address
 	uint8_t TimerMapping::get(uint16_t address) {
+		update();
 		switch (address) {
 			case OFFSET_DIVIDER:  // DIV
-				return (*m_divider) >> 8;
+				return divider() >> 8;
 			case OFFSET_COUNTER:  // TIMA
 				return counter;
 			case OFFSET_MODULO:  // TMA
@@ -68,10 +74,10 @@ namespace toygb {
 
 	// Set the value at the given relative address
 	void TimerMapping::set(uint16_t address, uint8_t value) {
+		update();
 		switch (address) {
 			case OFFSET_DIVIDER:  // DIV : Reset the divider on any write
-				dividerChange(0);
-				*m_divider = 0;
+				resetDivider();
 				break;
 			case OFFSET_COUNTER:  // TIMA
 				if (m_timaReloadDelay != 0)  // FIXME
@@ -80,16 +86,32 @@ namespace toygb {
 			case OFFSET_MODULO:  // TMA
 				modulo = value;
 				break;
-			case OFFSET_CONTROL:  // TAC
+			case OFFSET_CONTROL: {  // TAC
+				// TIMA is actually clocked by (enable AND trigger bit), so changing the settings while it is high also increments TIMA
+				bool previousTrigger = enable && ((divider() >> TIMA_TRIGGER_BITS[clockSelect]) & 1);
 				enable = (value >> 2) & 1;
 				clockSelect = value & 3;
+				bool newTrigger = enable && ((divider() >> TIMA_TRIGGER_BITS[clockSelect]) & 1);
+				if (previousTrigger && !newTrigger)
+					incrementCounter();
 				break;
+			}
 		}
 	}
 
-	// Execute actions associated to the divider changing its value
-	void TimerMapping::dividerChange(uint16_t newValue) {
-		if (m_timaReloadDelay != 0xFF) {  // We are in the delay between TIMA overflow and its reloading with TMA : advance the reload period
+	// Get the current value of the internal counter
+	uint16_t TimerMapping::divider() const {
+		return uint16_t(*m_clock - m_dividerOrigin);
+	}
+
+	// Reset the internal counter, as if it changed value without ticking
+	void TimerMapping::resetDivider() {
+		if (m_lazyComponent != nullptr)
+			m_lazyComponent->catchUp();
+		update();
+
+		// The reset still advances the reload period
+		if (m_timaReloadDelay != 0xFF) {
 			m_timaReloadDelay -= 1;
 			if (m_timaReloadDelay == 0) {
 				counter = modulo;
@@ -97,18 +119,87 @@ namespace toygb {
 			}
 		}
 
-		// Check divider bits for TIMA increments
-		if (enable) {
-			// Increment if the trigger bit goes from 1 to 0, regardless of whether it was an internal counter increment, reset or overflow
-			if ((HIGH_TO_LOW(*m_divider, newValue) >> TIMA_TRIGGER_BITS[clockSelect]) & 1) {
-				if (counter == 0xFF) {  // TIMA overflow : timer interrupt, set TIMA to 0 and go in the 4-clock delay before reloading with TMA
-					m_interrupt->setRequest(Interrupt::Timer);
-					counter = 0;
-					m_timaReloadDelay = 4;
+		// Increment if the trigger bit goes from 1 to 0, regardless of whether it was an internal counter increment, reset or overflow
+		if (enable && ((divider() >> TIMA_TRIGGER_BITS[clockSelect]) & 1))
+			incrementCounter();
+
+		m_dividerOrigin = *m_clock;
+	}
+
+	// Set the component that must catch up with the divider before it is reset (see LazyComponent)
+	void TimerMapping::setLazyComponent(LazyComponent* component) {
+		m_lazyComponent = component;
+	}
+
+	// Apply all TIMA increments and reloads that happened since the last update
+	// Equivalent to checking the trigger bit at every tick of the internal counter, in that order : reload with TMA, then increment
+	void TimerMapping::update() {
+		uint64_t now = *m_clock;
+		while (m_lastUpdate < now) {
+			// We are in the delay between TIMA overflow and its reloading with TMA
+			// TIMA can’t overflow during that time, as it is 0 and the reload delay is shorter than the fastest increment period
+			if (m_timaReloadDelay != 0xFF) {
+				uint64_t reloadClock = m_lastUpdate + m_timaReloadDelay;
+				if (reloadClock > now) {
+					counter += countTriggers(m_lastUpdate, now);
+					m_timaReloadDelay -= now - m_lastUpdate;
+					m_lastUpdate = now;
 				} else {
-					counter += 1;
+					counter += countTriggers(m_lastUpdate, reloadClock - 1);
+					counter = modulo;
+					m_timaReloadDelay = 0xFF;
+					if (countTriggers(reloadClock - 1, reloadClock) > 0)
+						incrementCounter();
+					m_lastUpdate = reloadClock;
 				}
 			}
+
+			// Normal operation : stop at the first overflow, if there is one in the interval
+			else {
+				uint64_t overflowClock = nextEvent();
+				if (overflowClock <= now) {
+					counter = 0xFF;
+					incrementCounter();
+					m_lastUpdate = overflowClock;
+				} else {
+					counter += countTriggers(m_lastUpdate, now);
+					m_lastUpdate = now;
+				}
+			}
+		}
+	}
+
+	// Tell when TIMA is going to overflow (or to be reloaded with TMA, as the next overflow then depends on TMA)
+	uint64_t TimerMapping::nextEvent() const {
+		if (m_timaReloadDelay != 0xFF)
+			return m_lastUpdate + m_timaReloadDelay;
+		if (!enable)
+			return UINT64_MAX;
+
+		// Falling edges of the trigger bit happen when the internal counter is a multiple of 2^(bit+1)
+		// The 16-bits overflow of the internal counter does not matter, as 2^16 is a multiple of that period
+		int shift = TIMA_TRIGGER_BITS[clockSelect] + 1;
+		uint64_t edges = 0x100 - counter;  // Increments left before overflowing
+		return m_dividerOrigin + ((((m_lastUpdate - m_dividerOrigin) >> shift) + edges) << shift);
+	}
+
+	// Count the falling edges of the trigger bit within the given clock interval
+	uint64_t TimerMapping::countTriggers(uint64_t start, uint64_t end) const {
+		if (!enable)
+			return 0;
+
+		int shift = TIMA_TRIGGER_BITS[clockSelect] + 1;
+		return ((end - m_dividerOrigin) >> shift) - ((start - m_dividerOrigin) >> shift);
+	}
+
+	// Increment TIMA once
+	void TimerMapping::incrementCounter() {
+		if (counter == 0xFF) {  // TIMA overflow : timer interrupt, set TIMA to 0 and go in the 4-clock delay before reloading with TMA
+			m_interrupt->setRequest(Interrupt::Timer);
+			counter = 0;
+			m_timaReloadDelay = 4;
+		} else {
+			counter += 1;
 		}
 	}
 }
@@ -11,8 +11,9 @@ Abs. addr. | Rel. addr. | Name | Access   | Content
 
 namespace toygb {
 	// Initialize the memory mapping
-	WRAMBankSelectMapping::WRAMBankSelectMapping(uint8_t* reg) {
+	WRAMBankSelectMapping::WRAMBankSelectMapping(uint8_t* reg, MemoryMapping* wramMapping) {
 		m_register = reg;
+		m_wramMapping = wramMapping;
 	}
 
 	// Get the value at the given relative address
@@ -26,5 +27,8 @@ namespace toygb {
 		 	*m_register = 1;
 		else
 			*m_register = value & 7;
+
+		// The switchable bank is mapped in 0xD000-0xDFFF
+		m_wramMapping->updateDirectAccess(WRAM_BANK_SIZE, 2*WRAM_BANK_SIZE - 1);
 	}
 }
@@ -12,24 +12,32 @@
 // CGB RGB color value for a blank pixel
 #define COLOR_BLANK 0x6318
 
+// Shared pixel buffer state : index of the buffer in the lower bits, and a flag telling whether it holds a frame the consumer has not taken yet
+#define FRAMEBUFFER_INDEX_MASK 0b011
+#define FRAMEBUFFER_READY_FLAG 0b100
+
 namespace toygb {
 	// Possible objects heights, defined by LCDC.2, in pixels
 	const uint8_t OBJECT_HEIGHTS[] = {8, 16};
 
-	// Default RGB555 color values for DMG colors
-	const uint16_t DMG_PALETTE[] = {0x6318, 0x4A52, 0x2108, 0x18C6};
-
 	// Possible tile map positions for the window and background (index is defined by LCDC.3 (background) and LCDC.6 (window))
 	const uint16_t TILEMAP_VRAM_ADDRESS[] = {0x1800, 0x1C00};
 
+	// Placeholder tile row for the lines that are not drawn (see LCDController::setFrameSkip)
+	const uint8_t SKIPPED_ROW[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+
 	/** FIXME : This is not a fully cycle-accurate implementation of the PPU, many details remain inaccurate or unclear.
-	 *  As of now it works well enough to emulate most games relatively well, and passes Matt Curie's dmg_acid2 test
-	 *  So TODO : Make this better */
+	 *  As of now it works well enough to emulate most games relatively well, and the pixel FIFO path passed Matt Curie's dmg_acid2 test
+	 *  The whole-line renderer (see LCDController::renderLine) has only been checked to give the same frames as the FIFO path on other test ROMs,
+	 *  it has not been run against dmg_acid2 itself yet
+	 *  So TODO : Make this better, and check renderLine against dmg_acid2 */
 
 	// Initialize the component with null values (the actual initialization is in LCDController::init)
 	LCDController::LCDController() {
 		m_vram = nullptr;
 		m_oam = nullptr;
+		m_tileCache = nullptr;
+		m_objectCache = nullptr;
 
 		m_dmgPalette = nullptr;
 		m_cgbPalette = nullptr;
@@ -38,14 +46,40 @@ namespace toygb {
 		m_vramMapping = nullptr;
 		m_oamMapping = nullptr;
 
-		m_backBuffer = nullptr;
-
+		for (int i = 0; i < 3; i++) {
+			m_buffers[i] = nullptr;
+			m_bufferFrames[i] = 0;
+		}
+		m_backBuffer = 0;
+		m_frontBuffer = 1;
+		m_sharedBuffer = 2;
+
+		m_pixelFormat = PixelFormat::RGBA8888;
+		m_pixelSize = pixelSize(m_pixelFormat);
+		m_blankColor = 0;
+
+		m_renderMode = RenderMode::Dots;
+		m_clock = 0;
+		m_lineStart = 0;
+		m_lineClocks = 0;
+		m_lineWrite = 0;
+		m_lineDoubleSpeed = false;
+		m_lineControl = nullptr;
+		m_linePalette = nullptr;
+
+		m_frameCount = 0;
+		m_frameSkip = 1;
+		m_drawFrame = true;
+		m_frameRequested = false;
+		m_displayStopped = false;
 		m_cyclesToSkip = 0;
 	}
 
 	LCDController::~LCDController() {
 		if (m_vram != nullptr) delete[] m_vram;
 		if (m_oam != nullptr) delete[] m_oam;
+		if (m_tileCache != nullptr) delete m_tileCache;
+		if (m_objectCache != nullptr) delete m_objectCache;
 
 		if (m_dmgPalette != nullptr) delete m_dmgPalette;
 		if (m_cgbPalette != nullptr) delete m_cgbPalette;
@@ -53,11 +87,17 @@ namespace toygb {
 		if (m_vramBankMapping != nullptr) delete m_vramBankMapping;
 		if (m_vramMapping != nullptr) delete m_vramMapping;
 		if (m_oamMapping != nullptr) delete m_oamMapping;
+		if (m_lineControl != nullptr) delete m_lineControl;
+		if (m_linePalette != nullptr) delete m_linePalette;
 
-		if (m_backBuffer != nullptr) delete[] m_backBuffer;
-		if (m_frontBuffer != nullptr) delete[] m_frontBuffer;
+		for (int i = 0; i < 3; i++) {
+			if (m_buffers[i] != nullptr) delete[] m_buffers[i];
+			m_buffers[i] = nullptr;
+		}
 
 		m_vram = m_oam = nullptr;
+		m_tileCache = nullptr;
+		m_objectCache = nullptr;
 
 		m_dmgPalette = nullptr;
 		m_cgbPalette = nullptr;
@@ -65,38 +105,53 @@ namespace toygb {
 		m_vramBankMapping = nullptr;
 		m_vramMapping = nullptr;
 		m_oamMapping = nullptr;
-
-		m_backBuffer = m_frontBuffer = nullptr;
+		m_lineControl = nullptr;
+		m_linePalette = nullptr;
 	}
 
 	// Initialize the component
-	void LCDController::init(HardwareStatus* hardware, InterruptVector* interrupt) {
+	void LCDController::init(HardwareStatus* hardware, InterruptVector* interrupt, PixelFormat format) {
 		m_hardware = hardware;
 		m_interrupt = interrupt;
 
 		m_oam = new uint8_t[OAM_SIZE];
 		for (int i = 0; i < OAM_SIZE; i++)  // FIXME : Clear OAM at boot ?
 			m_oam[i] = 0;
+		m_objectCache = new ObjectLineCache(m_oam);
 
 		switch (hardware->mode()) {
 			case OperationMode::DMG:
 				m_vram = new uint8_t[VRAM_SIZE];
 				for (int i = 0; i < VRAM_SIZE; i++)  // The bootrom clears VRAM
 					m_vram[i] = 0;
+				m_tileCache = new TileCache(m_vram, 1);
 				break;
 			case OperationMode::CGB:
 				m_vram = new uint8_t[VRAM_BANK_SIZE * VRAM_BANK_NUM];
 				for (int i = 0; i < VRAM_BANK_SIZE * VRAM_BANK_NUM; i++)
 					m_vram[i] = 0;
+				m_tileCache = new TileCache(m_vram, VRAM_BANK_NUM);
 				break;
 			case OperationMode::Auto:
 				throw EmulationError("OperationMode::Auto given to LCD controller");
 		}
 		m_vramBank = 0;
 
-		m_oamMapping = new OAMMapping(hardware, m_oam);
+		// Allocate the pixel buffers here, as the interface may read them before the PPU starts
+		m_pixelFormat = format;
+		m_pixelSize = pixelSize(format);
+		m_blankColor = hostColor(COLOR_BLANK, format);
+		for (int i = 0; i < 3; i++) {
+			m_buffers[i] = new uint8_t[LCD_WIDTH * LCD_HEIGHT * m_pixelSize];
+			for (int pixel = 0; pixel < LCD_WIDTH * LCD_HEIGHT; pixel++)
+				writePixel(m_buffers[i], pixel, m_blankColor, m_pixelSize);
+		}
+
+		m_oamMapping = new OAMMapping(hardware, m_oam, m_objectCache);
 		m_lcdControl = new LCDControlMapping(hardware);
-		m_dmgPalette = new DMGPaletteMapping();
+		m_dmgPalette = new DMGPaletteMapping(format);
+		m_lineControl = new LCDControlMapping(hardware);
+		m_linePalette = new DMGPaletteMapping(format);
 	}
 
 	// Configure the associated memory mappings
@@ -107,13 +162,13 @@ namespace toygb {
 
 		switch (m_hardware->mode()) {
 			case OperationMode::DMG:
-				m_vramMapping = new LCDMemoryMapping(m_vram);
+				m_vramMapping = new LCDMemoryMapping(m_vram, m_tileCache);
 				break;
 
 			case OperationMode::CGB:
-				m_cgbPalette = new CGBPaletteMapping(m_hardware);
+				m_cgbPalette = new CGBPaletteMapping(m_hardware, m_pixelFormat);
 				m_vramBankMapping = new VRAMBankSelectMapping(&m_vramBank);
-				m_vramMapping = new LCDBankedMemoryMapping(&m_vramBank, VRAM_BANK_SIZE, m_vram);
+				m_vramMapping = new LCDBankedMemoryMapping(&m_vramBank, VRAM_BANK_SIZE, m_vram, m_tileCache);
 
 				memory->add(IO_BGPALETTE_INDEX, IO_OBJPRIORITY, m_cgbPalette);
 				memory->add(IO_VRAM_BANK, IO_VRAM_BANK, m_vramBankMapping);
@@ -125,36 +180,43 @@ namespace toygb {
 		memory->add(VRAM_OFFSET, VRAM_OFFSET + VRAM_SIZE - 1, m_vramMapping);
 	}
 
-// Wait till the next clock in the coroutine
-#define clock(num) m_cyclesToSkip = num-1; \
-					co_await std::suspend_always(); \
+// Suspend the coroutine, and drop the current frame if the LCD has been disabled in the meantime (see LCDController::stopDisplay)
+#define suspend() { co_await std::suspend_always(); \
+                    if (m_displayStopped) goto displayStopped; }
+
+// Wait till the next clock in the coroutine (see LCDController::waitClocks)
+#define clock(num) if (waitClocks(num)) \
+						suspend(); \
 					lineDots -= num
 
 	// Main coroutine component. This could be better if it was split into smaller functions, but the coroutine management forces it to be in one block
 	GBComponent LCDController::run() {
-		// Allocate the pixel buffers
-		m_frontBuffer = new uint16_t[LCD_WIDTH * LCD_HEIGHT];
-		m_backBuffer = new uint16_t[LCD_WIDTH * LCD_HEIGHT];
-		std::deque<uint16_t> selectedSprites;  // Will contain the objects selected for the current scanline
+		uint16_t selectedSprites[MAX_LINE_OBJECTS];  // Will contain the objects selected for the current scanline
+		int selectedCount = 0;                       // Number of objects selected for the current scanline
+		int nextSprite = 0;                          // Index of the first selected object that is not entirely on the left of the current X coordinate
+		LCDController::PixelFIFO backgroundQueue;    // Pixel FIFOs
+		LCDController::PixelFIFO objectQueue;
 		LCDController::ObjectSelectionComparator objComparator(m_hardware, m_oamMapping);
 
 		int lineDots = 0;
 		while (true) {
-			if (m_lcdControl->displayEnable) {  // FIXME : shutting down the display should stop it right away, not at the next frame
-				// Swap the pixel buffers
-				uint16_t* tmp = m_frontBuffer;
-				m_frontBuffer = m_backBuffer;
-				m_backBuffer = tmp;
+			if (m_lcdControl->displayEnable) {
+				// The PPU always starts again from the beginning of a frame when the LCD is enabled
+				m_displayStopped = false;
 
 				// Window rendering does not uses the position of the screen, but instead counts the lines already rendered during the current frame
 				// This is important if the window is enabled then moved within a frame
 				int windowLineCounter = 0;
 
+				// Skipped frames go through all the same steps with the same timings, only without fetching and drawing the pixels (see LCDController::setFrameSkip)
+				m_drawFrame = m_frameRequested.exchange(false, std::memory_order_relaxed) || (m_frameSkip > 0 && m_frameCount % m_frameSkip == 0);
+
 				// On-screen scanlines : 0-143
 				for (int line = 0; line < 144; line++) {
 					lineDots = 456;
 
-					selectedSprites.clear();
+					selectedCount = 0;
+					nextSprite = 0;
 					bool hasWindow = false;  // Tell whether the window was rendered on this scanline, to increment the window line counter
 
 					// Mode 2 : OAM scan
@@ -184,17 +246,40 @@ namespace toygb {
 					// Small inaccuracy : actually, OAM is scanned row by row, with a row = 8 bytes = 2 objects. FIXME : Does this have any incidence ?
 					// NOTE : the position described in OAM is (X + 8, Y + 16), to allow hiding a sprite by setting its coordinates to 0
 					// Sprites hidden by their X coordinate (X = 0 or X >= 160) still count on their scanlines
-					for (int obj = 0; obj < 40; obj++) {
-						uint16_t oamAddress = 4 * obj;
-						uint8_t yposition = m_oamMapping->lcdGet(oamAddress) - 16;
-						// yposition <= line < yposition + object height : this sprite is on the current scanline
-						// Only 10 sprites can be rendered on any given scanline, objects hidden by their X coordinate (X = 0 or X >= 160) still count for this limit
-						if (yposition <= line && line < yposition + OBJECT_HEIGHTS[m_lcdControl->objectSize] && selectedSprites.size() < 10)
-							selectedSprites.push_back(oamAddress);
-
-						clock(2);
-					}
-					std::sort(selectedSprites.begin(), selectedSprites.end(), objComparator);
+					// As for mode 3, the whole scan is done at once unless LCDC changes in the meantime (see LCDController::startLine)
+					// In that case the object size is the same during the whole scan, so the selection is already known (see ObjectLineCache)
+					int scanDots = lineDots;
+					startLine();
+					do {
+						selectedCount = 0;
+						lineDots = scanDots;
+						if (m_renderMode == RenderMode::Batch) {
+							selectedCount = m_objectCache->lineObjects(line, m_lcdControl->objectSize, selectedSprites);
+							clock(2 * OAM_OBJECTS);
+						} else {
+							for (int obj = 0; obj < OAM_OBJECTS; obj++) {
+								uint16_t oamAddress = 4 * obj;
+								uint8_t yposition = m_oamMapping->lcdGet(oamAddress) - 16;
+								// yposition <= line < yposition + object height : this sprite is on the current scanline
+								// Only 10 sprites can be rendered on any given scanline, objects hidden by their X coordinate (X = 0 or X >= 160) still count for this limit
+								if (yposition <= line && line < yposition + OBJECT_HEIGHTS[m_lcdControl->objectSize] && selectedCount < MAX_LINE_OBJECTS)
+									selectedSprites[selectedCount++] = oamAddress;
+
+								clock(2);
+							}
+							std::sort(selectedSprites, selectedSprites + selectedCount, objComparator);
+						}
+
+						if (m_renderMode == RenderMode::Batch) {
+							m_renderMode = RenderMode::Waiting;
+							m_cyclesToSkip = m_lineClocks - 1;
+							suspend();
+							if (m_renderMode == RenderMode::Replay)
+								swapLineRegisters();
+							else
+								m_renderMode = RenderMode::Dots;
+						}
+					} while (m_renderMode == RenderMode::Replay);
 
 					// Mode 3 = Drawing pixels
 					m_lcdControl->modeFlag = 3;
@@ -207,321 +292,329 @@ namespace toygb {
 							m_cgbPalette->accessible = false;
 					}
 
-					// Pixel FIFOs
-					std::deque<LCDController::Pixel> backgroundQueue;
-					std::deque<LCDController::Pixel> objectQueue;
-
-					bool wasInsideWindow = false;  // Keep track of what we were rendering (background / window) to clear the background FIFO accordingly
-					for (int x = 0; x < LCD_WIDTH; x++) {
-						// The WX register is window X coordinate + 7
-						bool insideWindow = m_lcdControl->windowEnable && (x >= m_dmgPalette->windowX - 7 && line >= m_dmgPalette->windowY);
-						if (insideWindow != wasInsideWindow)  // Clear the background queue if we were rendering the background and switch to the window (and vice-versa)
-							backgroundQueue.clear();
-						hasWindow |= insideWindow;
-
-						////////// Fetch background pixels
-
-						// Only reload the background FIFO once it is empty. The tile fetch operation here is wildly inaccurate.
-						if (backgroundQueue.empty()) {
-							// Get the tile index from the selected tilemap
-							uint16_t tileMapAddress = TILEMAP_VRAM_ADDRESS[insideWindow ? m_lcdControl->windowTilemapSelect : m_lcdControl->backgroundTilemapSelect];
-							uint8_t tileX, tileY, indexY;
-							if (insideWindow) {  // Window : scrolling registers define the position of the window within the screen -> x - WX
-								tileX = ((x - (m_dmgPalette->windowX - 7)) >> 3) & 0x1F;  // X tile index in the tilemap (>> 3 because tiles are 8x8 pixels)
-								tileY = (windowLineCounter >> 3) & 0x1F;                  // Y tile index in the tilemap
-								indexY = windowLineCounter & 7;                           // Y offset of the current scanline / window line relative to the tile
-							} else {  // Background : scrolling registers define the position of the screen within the background -> x + SCX
-								tileX = ((m_lcdControl->scrollX + x) >> 3) & 0x1F;
-								tileY = ((m_lcdControl->scrollY + line) >> 3) & 0x1F;
-								indexY = (m_lcdControl->scrollY + line) & 7;
-							}
+					// Try to render the whole scanline at once, then wait until the end of mode 3,
+					// unless a register write requires to render it again clock by clock from the start of the mode (see LCDController::startLine)
+					int modeDots = lineDots;
+					bool lineRendered = false;
+					startLine();
+					if (m_renderMode == RenderMode::Batch) {
+						lineDots -= renderLine(line, windowLineCounter, selectedSprites, selectedCount, &hasWindow, m_drawFrame);
+						m_renderMode = RenderMode::Waiting;
+						m_cyclesToSkip = m_lineClocks - 1;
+						suspend();
+						if (m_renderMode == RenderMode::Replay) {
+							swapLineRegisters();
+							lineDots = modeDots;
+							hasWindow = false;
+						} else {
+							m_renderMode = RenderMode::Dots;
+							lineRendered = true;
+						}
+					}
 
-							// The tilemap is a 32*32 array, most significant coordinate is the row
-							uint16_t tileMetadataAddress = tileMapAddress + 32 * tileY + tileX;
-							uint8_t tileIndex = m_vramMapping->lcdGet(tileMetadataAddress);
-							uint8_t control = 0;
-							if (m_hardware->mode() == OperationMode::CGB)
-								control = m_vramMapping->lcdGet(VRAM_BANK_SIZE + tileMetadataAddress);
-							clock(2);
-
-							// Get the tile data VRAM address from its index (all addresses are relative to their memory section, here relative to VRAM)
-							// Tiles 128-255 are always in 0x0800-0x0FFF, regardless of the tile data selector
-							// Then LCDC.4 = 1 -> tiles 0-127 are in 0x0000-0x07FF, LCDC.4 = 0 -> tiles 0-127 are in 0x1000-0x17FF
-							// Each tile data is 16 bytes, 8 rows of 2 bytes
-							uint16_t tileAddress;
-							if (tileIndex >= 128)
-								tileAddress = 0x0800 + (tileIndex - 128) * 16;
-							else if (m_lcdControl->backgroundDataSelect)  // LCDC.4 = 1 : Address from 0x0000
-								tileAddress = 0x0000 + tileIndex * 16;
-							else  // LCDC.4 = 0 : Address from 0x1000
-								tileAddress = 0x1000 + tileIndex * 16;
-
-							// In CGB mode, if the tile control byte, bit 6 is set, the tile is flipped vertically
-							// We thus count the tile data rows from the end instead of from the beginning (row 2 -> row 7-2)
-							if ((control >> 6) & 1)
-								indexY = 7 - indexY;
-
-							// Retrieve the 2-byte row to render from VRAM
-							// In CGB mode, bit 3 of the control byte controls the VRAM bank to take the tile data from
-							if (m_hardware->mode() == OperationMode::CGB && ((control >> 3) & 1))
-								tileAddress += VRAM_BANK_SIZE;
-							uint8_t tileLow = m_vramMapping->lcdGet(tileAddress + indexY * 2);
-							clock(2);
-							uint8_t tileHigh = m_vramMapping->lcdGet(tileAddress + indexY * 2 + 1);  // (Little endian, upper byte is second)
-							clock(4);
-
-							// Each row is in two bytes, bits of each byte are interleaved to build the 2-bits color index. Indices are the x coordinate within the tile :
-							// Upper byte : u0 u1 u2 u3 u4 u5 u6 u7 |
-							// Lower byte : l0 l1 l2 l3 l4 l5 l6 l7 | -> u0l0 u1l1 u2l2 u3l3 u4l4 u5l5 u6l6 u7l7
-							for (int i = 7; i >= 0; i--) {
-								// In CGB mode, background tiles can be flipped horizontally with bit 5 of the tile control byte
-								// We do that by taking bits from the end instead of from the beginning, much like Y flip
-								uint8_t color;
-								if (m_hardware->mode() == OperationMode::CGB && ((control >> 5) & 1))  // Flipped horizontally
-									color = (((tileHigh >> (7 - i)) & 1) << 1) | ((tileLow >> (7 - i)) & 1);
-								else
-									color = (((tileHigh >> i) & 1) << 1) | ((tileLow >> i) & 1);
-
-								// Get which palette to use from the OAM control byte
-								uint8_t palette;
-								bool priorityBit;
-								switch (m_hardware->mode()) {
-									case OperationMode::DMG:  // DMG mode : monochrome background palette
-										palette = BACKGROUND_PALETTE;
-										priorityBit = false;
-										break;
-									case OperationMode::CGB:  // CGB mode : BCPI/BCPD palette index is defined by bits 0-2 of the control byte
-										palette = control & 7;
-										priorityBit = (control >> 7) & 1;
-										break;
-									case OperationMode::Auto:
-										throw EmulationError("OperationMode::Auto given to LCD controller");
+					if (!lineRendered) {
+						backgroundQueue.clear();
+						objectQueue.clear();
+						nextSprite = 0;
+
+						bool wasInsideWindow = false;  // Keep track of what we were rendering (background / window) to clear the background FIFO accordingly
+						for (int x = 0; x < LCD_WIDTH; x++) {
+							// The WX register is window X coordinate + 7
+							bool insideWindow = m_lcdControl->windowEnable && (x >= m_dmgPalette->windowX - 7 && line >= m_dmgPalette->windowY);
+							if (insideWindow != wasInsideWindow)  // Clear the background queue if we were rendering the background and switch to the window (and vice-versa)
+								backgroundQueue.clear();
+							hasWindow |= insideWindow;
+
+							////////// Fetch background pixels
+
+							// Only reload the background FIFO once it is empty. The tile fetch operation here is wildly inaccurate.
+							if (backgroundQueue.empty()) {
+								// Get the tile index from the selected tilemap
+								uint16_t tileMapAddress = TILEMAP_VRAM_ADDRESS[insideWindow ? m_lcdControl->windowTilemapSelect : m_lcdControl->backgroundTilemapSelect];
+								uint8_t tileX, tileY, indexY;
+								if (insideWindow) {  // Window : scrolling registers define the position of the window within the screen -> x - WX
+									tileX = ((x - (m_dmgPalette->windowX - 7)) >> 3) & 0x1F;  // X tile index in the tilemap (>> 3 because tiles are 8x8 pixels)
+									tileY = (windowLineCounter >> 3) & 0x1F;                  // Y tile index in the tilemap
+									indexY = windowLineCounter & 7;                           // Y offset of the current scanline / window line relative to the tile
+								} else {  // Background : scrolling registers define the position of the screen within the background -> x + SCX
+									tileX = ((m_lcdControl->scrollX + x) >> 3) & 0x1F;
+									tileY = ((m_lcdControl->scrollY + line) >> 3) & 0x1F;
+									indexY = (m_lcdControl->scrollY + line) & 7;
 								}
 
-								LCDController::Pixel pixelData(color, palette, BACKGROUND_INDEX, priorityBit);
-								backgroundQueue.push_back(pixelData);
-							}
-							clock(1);
-						}
+								// The tilemap is a 32*32 array, most significant coordinate is the row
+								uint16_t tileMetadataAddress = tileMapAddress + 32 * tileY + tileX;
+								uint8_t tileIndex = m_vramMapping->lcdGet(tileMetadataAddress);
+								uint8_t control = 0;
+								if (m_hardware->mode() == OperationMode::CGB)
+									control = m_vramMapping->lcdGet(VRAM_BANK_SIZE + tileMetadataAddress);
+								clock(2);
+
+								// Get the tile data VRAM address from its index (all addresses are relative to their memory section, here relative to VRAM)
+								// Tiles 128-255 are always in 0x0800-0x0FFF, regardless of the tile data selector
+								// Then LCDC.4 = 1 -> tiles 0-127 are in 0x0000-0x07FF, LCDC.4 = 0 -> tiles 0-127 are in 0x1000-0x17FF
+								// Each tile data is 16 bytes, 8 rows of 2 bytes
+								uint16_t tileAddress;
+								if (tileIndex >= 128)
+									tileAddress = 0x0800 + (tileIndex - 128) * 16;
+								else if (m_lcdControl->backgroundDataSelect)  // LCDC.4 = 1 : Address from 0x0000
+									tileAddress = 0x0000 + tileIndex * 16;
+								else  // LCDC.4 = 0 : Address from 0x1000
+									tileAddress = 0x1000 + tileIndex * 16;
+
+								// In CGB mode, if the tile control byte, bit 6 is set, the tile is flipped vertically
+								// We thus count the tile data rows from the end instead of from the beginning (row 2 -> row 7-2)
+								if ((control >> 6) & 1)
+									indexY = 7 - indexY;
+
+								// Retrieve the row to render, already decoded from the 2 bytes in VRAM by the tile cache (see TileCache::decode)
+								// In CGB mode, bit 3 of the control byte controls the VRAM bank to take the tile data from,
+								// and background tiles can be flipped horizontally with bit 5 of the tile control byte
+								if (m_hardware->mode() == OperationMode::CGB && ((control >> 3) & 1))
+									tileAddress += VRAM_BANK_SIZE;
+								const uint8_t* tileRow = tileRowData(tileAddress, indexY, m_hardware->mode() == OperationMode::CGB && ((control >> 5) & 1));
+								clock(2);  // Lower byte
+								clock(4);  // Upper byte
+
+								for (int i = 0; i < 8; i++) {
+									uint8_t color = tileRow[i];
+
+									// Get which palette to use from the OAM control byte
+									uint8_t palette;
+									bool priorityBit;
+									switch (m_hardware->mode()) {
+										case OperationMode::DMG:  // DMG mode : monochrome background palette
+											palette = BACKGROUND_PALETTE;
+											priorityBit = false;
+											break;
+										case OperationMode::CGB:  // CGB mode : BCPI/BCPD palette index is defined by bits 0-2 of the control byte
+											palette = control & 7;
+											priorityBit = (control >> 7) & 1;
+											break;
+										case OperationMode::Auto:
+											throw EmulationError("OperationMode::Auto given to LCD controller");
+									}
 
-						////////// Fetch sprites
-						// NOTE : selectedSprites contains the OAM addresses of the selected sprites, but is sorted by sprite X coordinate
-						if (m_lcdControl->objectEnable && !selectedSprites.empty()) {
-							// Check whether a new sprite may be pushed
-							// In DMG mode, lower X coordinate gets priority, so a sprite already being drawn can not be overridden by a later one
-							// In CGB mode, lower OAM position gets priority, so a sprite already being drawn can be overridden if a next one has a lower oam address
-							// FIXME : Here we only check the immediately next one. If several sprites are in range, can a sprite 2 positions later preempt the current one ?
-
-							// Eliminate sprites that were earlier on the line (the current X coordinate is after their last pixel X coordinate)
-							// OAM defines the X coordinate + 8, so to detect this it's OAM X coordinate - 8 < current X - 8 <=> OAM X coordinate < current X
-							while (!selectedSprites.empty() && m_oamMapping->lcdGet(selectedSprites.front() + 1) <= x)
-								selectedSprites.pop_front();
-
-							bool pushSprite = objectQueue.empty() || (m_hardware->isCGBCapable() && !m_cgbPalette->objectPriority && selectedSprites.front() < objectQueue.front().oamAddress);
-							uint16_t spriteToPush = selectedSprites.front();
-
-							if (m_hardware->isCGBCapable() && !m_cgbPalette->objectPriority) {
-								for (std::deque<uint16_t>::iterator it = selectedSprites.begin(); it != selectedSprites.end() && m_oamMapping->lcdGet(*it + 1) - 8 < x; it++) {
-									if (*it < objectQueue.front().oamAddress)
-										pushSprite = true;
-									if (*it < spriteToPush)
-										spriteToPush = *it;
+									LCDController::Pixel pixelData(color, palette, BACKGROUND_INDEX, priorityBit);
+									backgroundQueue.push(pixelData);
 								}
+								clock(1);
 							}
-							if (pushSprite) {
-								objectQueue.clear();
-
-								// Check whether the next sprite must be rendered at the current X coordinate (only need to check the next one as selectedSprites is sorted by X coordinate).
-								// As always, OAM gives X + 8, so -8 everywhere to get the actual position on the screen (and the end position is OAM X coordinate - 8 + 8 = OAM X coordinate)
-								if (!selectedSprites.empty() && x >= m_oamMapping->lcdGet(selectedSprites.front() + 1) - 8 && x < m_oamMapping->lcdGet(selectedSprites.front() + 1)) {
-									if (m_hardware->mode() == OperationMode::DMG)  // DMG mode : No problem, priority goes to the lowest X coordinate, so the first in selectedSprites
-										selectedSprites.pop_front();
-									clock(1);
-
-									// FIXME : Delay if the background scrolling is not a multiple of 8. This is probably not accurate at all.
-									uint8_t scrollOffset = m_lcdControl->scrollX % 8;
-									if (scrollOffset > 0 && x == 0) {
-										clock(scrollOffset + 4);
-									}
 
-									// Read the OAM entry of the sprite to render
-									// FIXME : Isn't this done in OAM scan ?
-									uint8_t tileIndex = m_oamMapping->lcdGet(spriteToPush + 2);
-									int xoffset = x - (m_oamMapping->lcdGet(spriteToPush + 1) - 8);
-									int yoffset = line - (m_oamMapping->lcdGet(spriteToPush) - 16);
-									uint8_t control = m_oamMapping->lcdGet(spriteToPush + 3);
+							////////// Fetch sprites
+							// NOTE : selectedSprites contains the OAM addresses of the selected sprites, but is sorted by sprite X coordinate
+							if (m_lcdControl->objectEnable && nextSprite < selectedCount) {
+								// Check whether a new sprite may be pushed
+								// In DMG mode, lower X coordinate gets priority, so a sprite already being drawn can not be overridden by a later one
+								// In CGB mode, lower OAM position gets priority, so a sprite already being drawn can be overridden if a next one has a lower oam address
+								// FIXME : Here we only check the immediately next one. If several sprites are in range, can a sprite 2 positions later preempt the current one ?
+
+								// Eliminate sprites that were earlier on the line (the current X coordinate is after their last pixel X coordinate)
+								// OAM defines the X coordinate + 8, so to detect this it's OAM X coordinate - 8 < current X - 8 <=> OAM X coordinate < current X
+								while (nextSprite < selectedCount && m_oamMapping->lcdGet(selectedSprites[nextSprite] + 1) <= x)
+									nextSprite += 1;
+
+								bool pushSprite = objectQueue.empty() || (m_hardware->isCGBCapable() && !m_cgbPalette->objectPriority && nextSprite < selectedCount && selectedSprites[nextSprite] < objectQueue.front().oamAddress());
+								uint16_t spriteToPush = (nextSprite < selectedCount ? selectedSprites[nextSprite] : 0);
+
+								if (m_hardware->isCGBCapable() && !m_cgbPalette->objectPriority) {
+									for (int i = nextSprite; i < selectedCount && m_oamMapping->lcdGet(selectedSprites[i] + 1) - 8 < x; i++) {
+										if (selectedSprites[i] < objectQueue.front().oamAddress())
+											pushSprite = true;
+										if (selectedSprites[i] < spriteToPush)
+											spriteToPush = selectedSprites[i];
+									}
+								}
+								if (pushSprite) {
+									objectQueue.clear();
+
+									// Check whether the next sprite must be rendered at the current X coordinate (only need to check the next one as selectedSprites is sorted by X coordinate).
+									// As always, OAM gives X + 8, so -8 everywhere to get the actual position on the screen (and the end position is OAM X coordinate - 8 + 8 = OAM X coordinate)
+									if (nextSprite < selectedCount && x >= m_oamMapping->lcdGet(selectedSprites[nextSprite] + 1) - 8 && x < m_oamMapping->lcdGet(selectedSprites[nextSprite] + 1)) {
+										if (m_hardware->mode() == OperationMode::DMG)  // DMG mode : No problem, priority goes to the lowest X coordinate, so the first in selectedSprites
+											nextSprite += 1;
+										clock(1);
+
+										// FIXME : Delay if the background scrolling is not a multiple of 8. This is probably not accurate at all.
+										uint8_t scrollOffset = m_lcdControl->scrollX % 8;
+										if (scrollOffset > 0 && x == 0) {
+											clock(scrollOffset + 4);
+										}
 
-									// If sprites are 8x16 (= 2 tiles), tile index alignment to a multiple of 2 is enforced by the PPU by always clearing the lowest bit
-									if (m_lcdControl->objectSize)
-										tileIndex &= 0xFE;
+										// Read the OAM entry of the sprite to render
+										// FIXME : Isn't this done in OAM scan ?
+										uint8_t tileIndex = m_oamMapping->lcdGet(spriteToPush + 2);
+										int xoffset = x - (m_oamMapping->lcdGet(spriteToPush + 1) - 8);
+										int yoffset = line - (m_oamMapping->lcdGet(spriteToPush) - 16);
+										uint8_t control = m_oamMapping->lcdGet(spriteToPush + 3);
 
-									// Contrary to the background / window, sprites always use the 0x0000-0x1000 tile data addressing, so no problem at all
-									uint16_t tileAddress = tileIndex * 16;
-									if (m_hardware->mode() == OperationMode::CGB && ((control >> 3) & 1))
-										tileAddress += VRAM_BANK_SIZE;
+										// If sprites are 8x16 (= 2 tiles), tile index alignment to a multiple of 2 is enforced by the PPU by always clearing the lowest bit
+										if (m_lcdControl->objectSize)
+											tileIndex &= 0xFE;
 
-									// If OAM control byte, bit 6 is set, the tile is flipped vertically
-									// We thus count the tile data rows from the end instead of from the beginning (row 2 -> row 7-2 / 15-2)
-									if ((control >> 6) & 1)
-										yoffset = OBJECT_HEIGHTS[m_lcdControl->objectSize] - yoffset - 1;
+										// Contrary to the background / window, sprites always use the 0x0000-0x1000 tile data addressing, so no problem at all
+										uint16_t tileAddress = tileIndex * 16;
+										if (m_hardware->mode() == OperationMode::CGB && ((control >> 3) & 1))
+											tileAddress += VRAM_BANK_SIZE;
 
-									// Retrieve the tile data row from VRAM, much like background
-									uint8_t tileLow = m_vramMapping->lcdGet(tileAddress + 2*yoffset);
-									uint8_t tileHigh = m_vramMapping->lcdGet(tileAddress + 2*yoffset + 1);
-									clock(1);
+										// If OAM control byte, bit 6 is set, the tile is flipped vertically
+										// We thus count the tile data rows from the end instead of from the beginning (row 2 -> row 7-2 / 15-2)
+										if ((control >> 6) & 1)
+											yoffset = OBJECT_HEIGHTS[m_lcdControl->objectSize] - yoffset - 1;
 
-									// See above, bits organisation and color bits interleave are described in the same part of the background row fetching
-									for (int i = 7 - xoffset; i >= 0; i--) {
-										uint8_t color;
+										// The object size may have changed since the OAM scan, only the lower bits of the row index are used then
+										yoffset &= OBJECT_HEIGHTS[m_lcdControl->objectSize] - 1;
 
+										// Retrieve the decoded tile data row, much like background (8x16 objects continue on the next tile)
 										// Objects can be flipped horizontally with bit 5 of the OAM control byte
-										// We do that by taking bits from the end instead of from the beginning, much like Y flip
-										if ((control >> 5) & 1)  // Flipped horizontally
-											color = (((tileHigh >> (7 - i)) & 1) << 1) | ((tileLow >> (7 - i)) & 1);
-										else
-											color = (((tileHigh >> i) & 1) << 1) | ((tileLow >> i) & 1);
-
-										// Get which palette to use from the OAM control byte
-										uint8_t palette;
-										switch (m_hardware->mode()) {
-											case OperationMode::DMG:  // DMG mode : set by bit 4 of the control byte (0 = OBP0, 1 = OBP1)
-												palette = (control >> 4) & 1;
-												break;
-											case OperationMode::CGB:  // CGB mode : OBPS/OBPD palette index is defined by bits 0-3
-												palette = control & 7;
-												break;
-											case OperationMode::Auto:
-												throw EmulationError("OperationMode::Auto given to LCD controller");
+										const uint8_t* tileRow = tileRowData(tileAddress + (yoffset >> 3) * TILE_SIZE, yoffset & 7, (control >> 5) & 1);
+										clock(1);
+
+										for (int i = xoffset; i < 8; i++) {
+											uint8_t color = tileRow[i];
+
+											// Get which palette to use from the OAM control byte
+											uint8_t palette;
+											switch (m_hardware->mode()) {
+												case OperationMode::DMG:  // DMG mode : set by bit 4 of the control byte (0 = OBP0, 1 = OBP1)
+													palette = (control >> 4) & 1;
+													break;
+												case OperationMode::CGB:  // CGB mode : OBPS/OBPD palette index is defined by bits 0-3
+													palette = control & 7;
+													break;
+												case OperationMode::Auto:
+													throw EmulationError("OperationMode::Auto given to LCD controller");
+											}
+
+											// Object-to-background priority is set by bit 7 of the control byte (0 = object colors 1-3 above background, 1 = background colors 1-3 above objects)
+											LCDController::Pixel pixel(color, palette, spriteToPush, (control >> 7) & 1);
+											objectQueue.push(pixel);
 										}
-
-										// Object-to-background priority is set by bit 7 of the control byte (0 = object colors 1-3 above background, 1 = background colors 1-3 above objects)
-										LCDController::Pixel pixel(color, palette, spriteToPush, (control >> 7) & 1);
-										objectQueue.push_back(pixel);
 									}
 								}
 							}
-						}
 
 
-						////////// Pixel rendering
-						// NOTE : Here, "colorValue" means the color index before resolving it with a palette, "color" means the final color that will get displayed, after palettes resolution
+							////////// Pixel rendering
+							// NOTE : Here, "colorValue" means the color index before resolving it with a palette, "color" means the final color that will get displayed, after palettes resolution
 
-						// If the background scrolling is not a multiple of 8 (= on the exact edge of a tile),
-						// eliminate the pixels of the first tile that are outside of the screen on the left
-						if (x == 0) {
-							for (int i = 0; i < m_lcdControl->scrollX % 8; i++)
-								backgroundQueue.pop_front();
-						}
-						LCDController::Pixel backgroundPixel = backgroundQueue.front();
-						backgroundQueue.pop_front();
-
-						// In DMG mode, if the LCDC.0 is clear, background is disabled so everything not covered by sprites is blank
-						// In CGB mode, this does only affect the background-to-object priority, that is handled later on
-						uint8_t colorValue;
-						if (m_hardware->mode() == OperationMode::DMG && !m_lcdControl->backgroundDisplay)
-							colorValue = COLORVALUE_BLANK;
-						else
-							colorValue = backgroundPixel.color;
-
-						uint8_t colorPalette = backgroundPixel.palette;
-						uint16_t elementIndex = backgroundPixel.oamAddress;
-
-						// If there is an object pixel AND a background pixel, select which one to render
-						if (!objectQueue.empty()) {
-							LCDController::Pixel objectPixel = objectQueue.front();
-							objectQueue.pop_front();
-
-							// TODO : Add CGB-mode priority shenanigans
-							// Basically, in order of decreasing importance [CGB LCDC.0 > BG priority bit >] Object priority bit
-							// The logic is heavily reduced, but here is a table to explain all that (- = any value) :
-							// Operation | LCDC.0 (background | BG priority bit (VRAM  | Object priority bit   | Object value | Background value | Value to
-							// mode      | enable / priority) | bank 1 attribute byte) | (in OAM control byte) |              |                  | render
-							// --------- | ------------------ | ---------------------- | --------------------- | ------------ | ---------------- | --------
-							//       DMG |                  1 |                        |                     0 |         zero |             zero | BG
-							//       DMG |                  1 |                        |                     0 |     non-zero |             zero | OBJ
-							//       DMG |                  1 |                        |                     0 |         zero |         non-zero | BG
-							//       DMG |                  1 |                        |                     0 |     non-zero |         non-zero | OBJ
-							//       DMG |                  1 |                        |                     1 |         zero |             zero | BG
-							//       DMG |                  1 |                        |                     1 |     non-zero |             zero | OBJ
-							//       DMG |                  1 |                        |                     1 |         zero |         non-zero | BG
-							//       DMG |                  1 |                        |                     1 |     non-zero |         non-zero | BG
-							//       DMG |                  0 |                        |                     - |         zero |                - | blank
-							//       DMG |                  0 |                        |                     - |     non-zero |                - | OBJ
-							// --------- | ------------------ | ---------------------- | --------------------- | ------------ | ---------------- | --------
-							//       CGB |                  1 |                      0 |                     0 |         zero |             zero | BG
-							//       CGB |                  1 |                      0 |                     0 |     non-zero |             zero | OBJ
-							//       CGB |                  1 |                      0 |                     0 |         zero |         non-zero | BG
-							//       CGB |                  1 |                      0 |                     0 |     non-zero |         non-zero | OBJ
-							//       CGB |                  1 |                      0 |                     1 |         zero |             zero | BG
-							//       CGB |                  1 |                      0 |                     1 |     non-zero |             zero | OBJ
-							//       CGB |                  1 |                      0 |                     1 |         zero |         non-zero | BG
-							//       CGB |                  1 |                      0 |                     1 |     non-zero |         non-zero | BG
-							//       CGB |                  1 |                      1 |                     - |         zero |             zero | BG
-							//       CGB |                  1 |                      1 |                     - |     non-zero |             zero | OBJ
-							//       CGB |                  1 |                      1 |                     - |         zero |         non-zero | BG
-							//       CGB |                  1 |                      1 |                     - |     non-zero |         non-zero | BG
-							//       CGB |                  0 |                      - |                     - |         zero |             zero | BG
-							//       CGB |                  0 |                      - |                     - |     non-zero |             zero | OBJ
-							//       CGB |                  0 |                      - |                     - |         zero |         non-zero | BG
-							//       CGB |                  0 |                      - |                     - |     non-zero |         non-zero | OBJ
-							bool objectHasPriority = (objectPixel.color > 0) && (!m_lcdControl->backgroundDisplay || backgroundPixel.color == 0 || (!objectPixel.priority && (m_hardware->mode() == OperationMode::DMG || !backgroundPixel.priority)));
-
-							/*if (objectPixel.priority) {
-								if (!m_lcdControl->backgroundDisplay) {
-									objectHasPriority = (objectPixel.color > 0);
+							// If the background scrolling is not a multiple of 8 (= on the exact edge of a tile),
+							// eliminate the pixels of the first tile that are outside of the screen on the left
+							if (x == 0) {
+								for (int i = 0; i < m_lcdControl->scrollX % 8; i++)
+									backgroundQueue.pop();
+							}
+							LCDController::Pixel backgroundPixel = backgroundQueue.front();
+							backgroundQueue.pop();
+
+							// In DMG mode, if the LCDC.0 is clear, background is disabled so everything not covered by sprites is blank
+							// In CGB mode, this does only affect the background-to-object priority, that is handled later on
+							uint8_t colorValue;
+							if (m_hardware->mode() == OperationMode::DMG && !m_lcdControl->backgroundDisplay)
+								colorValue = COLORVALUE_BLANK;
+							else
+								colorValue = backgroundPixel.color();
+
+							uint8_t colorPalette = backgroundPixel.palette();
+							uint16_t elementIndex = backgroundPixel.oamAddress();
+
+							// If there is an object pixel AND a background pixel, select which one to render
+							if (!objectQueue.empty()) {
+								LCDController::Pixel objectPixel = objectQueue.front();
+								objectQueue.pop();
+
+								// TODO : Add CGB-mode priority shenanigans
+								// Basically, in order of decreasing importance [CGB LCDC.0 > BG priority bit >] Object priority bit
+								// The logic is heavily reduced, but here is a table to explain all that (- = any value) :
+								// Operation | LCDC.0 (background | BG priority bit (VRAM  | Object priority bit   | Object value | Background value | Value to
+								// mode      | enable / priority) | bank 1 attribute byte) | (in OAM control byte) |              |                  | render
+								// --------- | ------------------ | ---------------------- | --------------------- | ------------ | ---------------- | --------
+								//       DMG |                  1 |                        |                     0 |         zero |             zero | BG
+								//       DMG |                  1 |                        |                     0 |     non-zero |             zero | OBJ
+								//       DMG |                  1 |                        |                     0 |         zero |         non-zero | BG
+								//       DMG |                  1 |                        |                     0 |     non-zero |         non-zero | OBJ
+								//       DMG |                  1 |                        |                     1 |         zero |             zero | BG
+								//       DMG |                  1 |                        |                     1 |     non-zero |             zero | OBJ
+								//       DMG |                  1 |                        |                     1 |         zero |         non-zero | BG
+								//       DMG |                  1 |                        |                     1 |     non-zero |         non-zero | BG
+								//       DMG |                  0 |                        |                     - |         zero |                - | blank
+								//       DMG |                  0 |                        |                     - |     non-zero |                - | OBJ
+								// --------- | ------------------ | ---------------------- | --------------------- | ------------ | ---------------- | --------
+								//       CGB |                  1 |                      0 |                     0 |         zero |             zero | BG
+								//       CGB |                  1 |                      0 |                     0 |     non-zero |             zero | OBJ
+								//       CGB |                  1 |                      0 |                     0 |         zero |         non-zero | BG
+								//       CGB |                  1 |                      0 |                     0 |     non-zero |         non-zero | OBJ
+								//       CGB |                  1 |                      0 |                     1 |         zero |             zero | BG
+								//       CGB |                  1 |                      0 |                     1 |     non-zero |             zero | OBJ
+								//       CGB |                  1 |                      0 |                     1 |         zero |         non-zero | BG
+								//       CGB |                  1 |                      0 |                     1 |     non-zero |         non-zero | BG
+								//       CGB |                  1 |                      1 |                     - |         zero |             zero | BG
+								//       CGB |                  1 |                      1 |                     - |     non-zero |             zero | OBJ
+								//       CGB |                  1 |                      1 |                     - |         zero |         non-zero | BG
+								//       CGB |                  1 |                      1 |                     - |     non-zero |         non-zero | BG
+								//       CGB |                  0 |                      - |                     - |         zero |             zero | BG
+								//       CGB |                  0 |                      - |                     - |     non-zero |             zero | OBJ
+								//       CGB |                  0 |                      - |                     - |         zero |         non-zero | BG
+								//       CGB |                  0 |                      - |                     - |     non-zero |         non-zero | OBJ
+								bool objectHasPriority = (objectPixel.color() > 0) && (!m_lcdControl->backgroundDisplay || backgroundPixel.color() == 0 || (!objectPixel.priority() && (m_hardware->mode() == OperationMode::DMG || !backgroundPixel.priority())));
+
+								/*if (objectPixel.priority) {
+									if (!m_lcdControl->backgroundDisplay) {
+										objectHasPriority = (objectPixel.color > 0);
+									} else {
+										objectHasPriority = (backgroundPixel.color == 0);
+									}
 								} else {
-									objectHasPriority = (backgroundPixel.color == 0);
+									objectHasPriority = (objectPixel.color > 0);
+								}*/
+
+								// If we determined the object pixel must replace the background one
+								if (objectHasPriority) {
+									colorValue = objectPixel.color();
+									colorPalette = objectPixel.palette();
+									elementIndex = objectPixel.oamAddress();
 								}
-							} else {
-								objectHasPriority = (objectPixel.color > 0);
-							}*/
-
-							// If we determined the object pixel must replace the background one
-							if (objectHasPriority) {
-								colorValue = objectPixel.color;
-								colorPalette = objectPixel.palette;
-								elementIndex = objectPixel.oamAddress;
 							}
-						}
 
-						// Resolve the actual color to render with the color index and the palette
-						uint16_t colorResult;
+							// Resolve the actual color to render with the color index and the palette
+							uint32_t colorResult;
 
-						if (colorValue == COLORVALUE_BLANK) {
-							colorResult = COLOR_BLANK;
-						}
+							if (colorValue == COLORVALUE_BLANK) {
+								colorResult = m_blankColor;
+							}
 
-						// CGB mode : Resolve with CGB palettes (BCPD / OCPD)
-						else if (m_hardware->isCGBCapable()) {
-							if (m_hardware->mode() == OperationMode::CGB) {
-								// Calculate the index in the palette data array
-								int paletteIndex = colorPalette * 4 + colorValue;
-								if (elementIndex == BACKGROUND_INDEX)
-									colorResult = m_cgbPalette->backgroundPalettes[paletteIndex];
-								else
-									colorResult = m_cgbPalette->objectPalettes[paletteIndex];
-							} else {
-								if (colorPalette == BACKGROUND_PALETTE)
-									colorResult = m_cgbPalette->backgroundPalettes[colorValue];
-								else
-									colorResult = m_cgbPalette->objectPalettes[colorPalette * 4 + colorValue];
+							// CGB mode : Resolve with CGB palettes (BCPD / OCPD)
+							else if (m_hardware->isCGBCapable()) {
+								if (m_hardware->mode() == OperationMode::CGB) {
+									// Calculate the index in the palette data array
+									int paletteIndex = colorPalette * 4 + colorValue;
+									if (elementIndex == BACKGROUND_INDEX)
+										colorResult = m_cgbPalette->backgroundColors[paletteIndex];
+									else
+										colorResult = m_cgbPalette->objectColors[paletteIndex];
+								} else {
+									if (colorPalette == BACKGROUND_PALETTE)
+										colorResult = m_cgbPalette->backgroundColors[colorValue];
+									else
+										colorResult = m_cgbPalette->objectColors[colorPalette * 4 + colorValue];
+								}
 							}
-						}
 
-						// DMG mode : Resolve with monochrome palettes (BGP / OBP0 / OBP1) and use the associated default RGB555 color
-						else {
-							if (colorPalette == BACKGROUND_PALETTE)
-								colorResult = DMG_PALETTE[m_dmgPalette->backgroundPalette[colorValue]];
-							else if (colorPalette == 0)
-								colorResult = DMG_PALETTE[m_dmgPalette->objectPalette0[colorValue]];
-							else if (colorPalette == 1)
-								colorResult = DMG_PALETTE[m_dmgPalette->objectPalette1[colorValue]];
-						}
+							// DMG mode : Resolve with monochrome palettes (BGP / OBP0 / OBP1) already converted to the host format
+							else {
+								if (colorPalette == BACKGROUND_PALETTE)
+									colorResult = m_dmgPalette->backgroundColors[colorValue];
+								else if (colorPalette == 0)
+									colorResult = m_dmgPalette->objectColors0[colorValue];
+								else if (colorPalette == 1)
+									colorResult = m_dmgPalette->objectColors1[colorValue];
+							}
 
-						// Finally render the pixel into the back pixels buffer
-						m_backBuffer[line * LCD_WIDTH + x] = colorResult;
+							// Finally render the pixel into the back pixels buffer
+							writePixel(m_buffers[m_backBuffer], line * LCD_WIDTH + x, colorResult, m_pixelSize);
 
-						wasInsideWindow = insideWindow;
+							wasInsideWindow = insideWindow;
+						}
 					}
 
 					// Mode 0 = HBlank
@@ -557,6 +650,13 @@ namespace toygb {
 				}
 
 				m_interrupt->setRequest(Interrupt::VBlank);
+				m_frameCount += 1;
+
+				// The frame is complete : publish it, and take back the buffer the consumer is not using to render the next one
+				if (m_drawFrame) {
+					m_bufferFrames[m_backBuffer] = m_frameCount;
+					m_backBuffer = m_sharedBuffer.exchange(m_backBuffer | FRAMEBUFFER_READY_FLAG, std::memory_order_acq_rel) & FRAMEBUFFER_INDEX_MASK;
+				}
 
 				// Off-screen scanlines (144-153)
 				for (int line = 144; line < 154; line++) {
@@ -572,24 +672,410 @@ namespace toygb {
 				// FIXME : Not sure about whether the interrupt request must be reset at the end of VBlank, common sense tells it should be but 80s hardware is not known to follow it
 				// m_interrupt->resetRequest(Interrupt::VBlank);
 			} else {
-				clock(1);
+				// The LCD is disabled : stay dormant until it is enabled again (see LCDController::skip)
+				m_cyclesToSkip = 0;
+				suspend();
+			}
+
+			displayStopped:;
+		}
+	}
+
+	// Get a decoded tile row for the clock-by-clock rendering (see TileCache::row)
+	// The PPU reads 0xFF from VRAM when it has not reserved it, that decodes to color 3 everywhere
+	const uint8_t* LCDController::tileRowData(uint16_t tileAddress, int row, bool flipped) {
+		static const uint8_t blockedRow[8] = {3, 3, 3, 3, 3, 3, 3, 3};
+		if (m_vramMapping->accessible)
+			return blockedRow;
+		return m_tileCache->row(tileAddress, row, flipped);
+	}
+
+	// Render a whole scanline at once, without suspending the PPU (see LCDController::startLine)
+	// This follows exactly the same rules as the clock-by-clock rendering in LCDController::run, including its inaccuracies,
+	// but works on whole tile rows and reads the memory directly instead of going through the pixel FIFOs and the memory mappings
+	// Returns the amount of clocks spent in mode 3, and accounts for them with waitClocks like the coroutine would
+	int LCDController::renderLine(int line, int windowLineCounter, const uint16_t* selectedSprites, int selectedCount, bool* hasWindow, bool draw) {
+		// The registers can not change during the scanline, and writing pixels through a byte pointer would force the compiler to reload them all the time
+		bool cgbCapable = m_hardware->isCGBCapable();
+		bool cgbMode = m_hardware->mode() == OperationMode::CGB;
+		bool cgbPriority = cgbCapable && !m_cgbPalette->objectPriority;  // Priority to the lowest OAM index instead of the lowest X coordinate
+		bool backgroundDisplay = m_lcdControl->backgroundDisplay;
+		bool objectEnable = m_lcdControl->objectEnable;
+		bool objectSize = m_lcdControl->objectSize;
+		bool windowEnable = m_lcdControl->windowEnable && line >= m_dmgPalette->windowY;
+		int windowStart = m_dmgPalette->windowX - 7;
+		uint8_t scrollX = m_lcdControl->scrollX;
+		uint8_t scrollY = m_lcdControl->scrollY;
+		uint8_t scrollOffset = scrollX % 8;
+		int objectHeight = OBJECT_HEIGHTS[objectSize];
+		uint16_t backgroundTilemap = TILEMAP_VRAM_ADDRESS[m_lcdControl->backgroundTilemapSelect];
+		uint16_t windowTilemap = TILEMAP_VRAM_ADDRESS[m_lcdControl->windowTilemapSelect];
+		bool backgroundDataSelect = m_lcdControl->backgroundDataSelect;
+		const uint8_t* vram = m_vram;
+		const uint8_t* oam = m_oam;
+		TileCache* tileCache = m_tileCache;
+
+		// Colors of all palettes in the host format, indexed as in composeLine
+		// In DMG compatibility mode, the background uses the first CGB background palette and the objects the first two CGB object palettes
+		uint32_t lineColors[LINE_COLORS_SIZE];
+		if (draw) {
+			if (cgbMode) {
+				std::copy(m_cgbPalette->backgroundColors, m_cgbPalette->backgroundColors + 8*4, lineColors + LINE_COLORS_BACKGROUND);
+				std::copy(m_cgbPalette->objectColors, m_cgbPalette->objectColors + 8*4, lineColors + LINE_COLORS_OBJECTS);
+			} else if (cgbCapable) {
+				std::copy(m_cgbPalette->backgroundColors, m_cgbPalette->backgroundColors + 4, lineColors + LINE_COLORS_BACKGROUND);
+				std::copy(m_cgbPalette->objectColors, m_cgbPalette->objectColors + 2*4, lineColors + LINE_COLORS_OBJECTS);
+			} else {
+				std::copy(m_dmgPalette->backgroundColors, m_dmgPalette->backgroundColors + 4, lineColors + LINE_COLORS_BACKGROUND);
+				std::copy(m_dmgPalette->objectColors0, m_dmgPalette->objectColors0 + 4, lineColors + LINE_COLORS_OBJECTS);
+				std::copy(m_dmgPalette->objectColors1, m_dmgPalette->objectColors1 + 4, lineColors + LINE_COLORS_OBJECTS + 4);
+			}
+			lineColors[LINE_COLORS_BLANK] = m_blankColor;
+		}
+
+		// The pixels are first put into separate layers, that are merged and resolved once the whole line is done (see LineKernels)
+		uint8_t backgroundLayer[LCD_WIDTH];
+		uint8_t objectLayer[LCD_WIDTH] = {0};  // Color 0 where there is no object
+		int dots = 0;
+
+		// Background FIFO : the background pixel FIFO always holds the end of a single tile row, with the same palette and priority
+		// The colors are read right from the decoded row in the tile cache, as VRAM can not change during the scanline
+		const uint8_t* backgroundColors = nullptr;
+		int backgroundIndex = 0;  // Index of the next background pixel in backgroundColors
+		int backgroundCount = 0;  // Number of pixels left in the background FIFO
+		uint8_t backgroundAttributes = 0;  // Palette and priority bits of the layer pixels
+
+		// Object FIFO : same, with the end of the row of the object being rendered
+		const uint8_t* objectColors = nullptr;
+		int objectIndex = 0;
+		int objectCount = 0;
+		uint8_t objectAttributes = 0;
+		uint16_t objectAddress = 0;
+
+		int nextSprite = 0;
+		bool wasInsideWindow = false;
+		for (int x = 0; x < LCD_WIDTH; x++) {
+			bool insideWindow = windowEnable && x >= windowStart;
+			if (insideWindow != wasInsideWindow)
+				backgroundCount = 0;
+			*hasWindow |= insideWindow;
+
+			////////// Fetch background pixels
+			// The fetch timings do not depend on the tile data, so the tiles are only read when the line is drawn
+			if (backgroundCount == 0) {
+				if (draw) {
+					uint16_t tileMapAddress = (insideWindow ? windowTilemap : backgroundTilemap);
+					uint8_t tileX, tileY, indexY;
+					if (insideWindow) {
+						tileX = ((x - windowStart) >> 3) & 0x1F;
+						tileY = (windowLineCounter >> 3) & 0x1F;
+						indexY = windowLineCounter & 7;
+					} else {
+						tileX = ((scrollX + x) >> 3) & 0x1F;
+						tileY = ((scrollY + line) >> 3) & 0x1F;
+						indexY = (scrollY + line) & 7;
+					}
+
+					uint16_t tileMetadataAddress = tileMapAddress + 32 * tileY + tileX;
+					uint8_t tileIndex = vram[tileMetadataAddress];
+					uint8_t control = (cgbMode ? vram[VRAM_BANK_SIZE + tileMetadataAddress] : 0);
+
+					uint16_t tileAddress;
+					if (tileIndex >= 128)
+						tileAddress = 0x0800 + (tileIndex - 128) * 16;
+					else if (backgroundDataSelect)
+						tileAddress = 0x0000 + tileIndex * 16;
+					else
+						tileAddress = 0x1000 + tileIndex * 16;
+
+					if ((control >> 6) & 1)
+						indexY = 7 - indexY;
+					if (cgbMode && ((control >> 3) & 1))
+						tileAddress += VRAM_BANK_SIZE;
+
+					backgroundColors = tileCache->row(tileAddress, indexY, cgbMode && ((control >> 5) & 1));
+					if (cgbMode)
+						backgroundAttributes = ((control & 7) << LAYER_PALETTE_SHIFT) | ((control >> 7) & 1 ? LAYER_PRIORITY : 0);
+				} else {
+					backgroundColors = SKIPPED_ROW;
+				}
+				backgroundIndex = 0;
+				backgroundCount = 8;
+
+				dots += 2; waitClocks(2);
+				dots += 2; waitClocks(2);
+				dots += 4; waitClocks(4);
+				dots += 1; waitClocks(1);
+			}
+
+			////////// Fetch sprites
+			if (objectEnable && nextSprite < selectedCount) {
+				while (nextSprite < selectedCount && oam[selectedSprites[nextSprite] + 1] <= x)
+					nextSprite += 1;
+
+				bool pushSprite = objectCount == 0 || (cgbPriority && nextSprite < selectedCount && selectedSprites[nextSprite] < objectAddress);
+				uint16_t spriteToPush = (nextSprite < selectedCount ? selectedSprites[nextSprite] : 0);
+				if (cgbPriority) {
+					for (int i = nextSprite; i < selectedCount && oam[selectedSprites[i] + 1] - 8 < x; i++) {
+						if (selectedSprites[i] < objectAddress)
+							pushSprite = true;
+						if (selectedSprites[i] < spriteToPush)
+							spriteToPush = selectedSprites[i];
+					}
+				}
+
+				if (pushSprite) {
+					objectCount = 0;
+					if (nextSprite < selectedCount && x >= oam[selectedSprites[nextSprite] + 1] - 8 && x < oam[selectedSprites[nextSprite] + 1]) {
+						if (!cgbMode)
+							nextSprite += 1;
+						dots += 1; waitClocks(1);
+						if (scrollOffset > 0 && x == 0) {
+							dots += scrollOffset + 4; waitClocks(scrollOffset + 4);
+						}
+
+						uint8_t tileIndex = oam[spriteToPush + 2];
+						int xoffset = x - (oam[spriteToPush + 1] - 8);
+						int yoffset = line - (oam[spriteToPush] - 16);
+						uint8_t control = oam[spriteToPush + 3];
+
+						if (objectSize)
+							tileIndex &= 0xFE;
+						uint16_t tileAddress = tileIndex * 16;
+						if (cgbMode && ((control >> 3) & 1))
+							tileAddress += VRAM_BANK_SIZE;
+						if ((control >> 6) & 1)
+							yoffset = objectHeight - yoffset - 1;
+						yoffset &= objectHeight - 1;
+
+						// 8x16 objects continue on the next tile
+						if (draw)
+							objectColors = tileCache->row(tileAddress + (yoffset >> 3) * TILE_SIZE, yoffset & 7, (control >> 5) & 1) + xoffset;
+						else
+							objectColors = SKIPPED_ROW;
+						dots += 1; waitClocks(1);
+
+						objectAttributes = ((cgbMode ? control & 7 : (control >> 4) & 1) << LAYER_PALETTE_SHIFT) | ((control >> 7) & 1 ? LAYER_PRIORITY : 0);
+						objectAddress = spriteToPush;
+						objectIndex = 0;
+						objectCount = 8 - xoffset;
+					}
+				}
+			}
+
+			////////// Pixel rendering
+			if (x == 0) {
+				backgroundIndex += scrollOffset;
+				backgroundCount -= scrollOffset;
+			}
+			backgroundLayer[x] = backgroundColors[backgroundIndex] | backgroundAttributes;
+			backgroundIndex += 1;
+			backgroundCount -= 1;
+
+			if (objectCount > 0) {
+				objectLayer[x] = objectColors[objectIndex] | objectAttributes;
+				objectIndex += 1;
+				objectCount -= 1;
 			}
+
+			// Without any object pixel left, the next pixels are plain background pixels until the background FIFO is empty,
+			// the window starts, or the next object may be fetched (the first one that has not been eliminated yet at this position)
+			if (objectCount == 0) {
+				int end = x + 1 + backgroundCount;
+				if (end > LCD_WIDTH)
+					end = LCD_WIDTH;
+				if (windowEnable && !insideWindow && windowStart < end)
+					end = windowStart;
+				if (objectEnable) {
+					for (int i = nextSprite; i < selectedCount; i++) {
+						if (oam[selectedSprites[i] + 1] > x) {
+							if (oam[selectedSprites[i] + 1] - 8 < end)
+								end = oam[selectedSprites[i] + 1] - 8;
+							break;
+						}
+					}
+				}
+
+				for (x++; x < end; x++) {
+					backgroundLayer[x] = backgroundColors[backgroundIndex] | backgroundAttributes;
+					backgroundIndex += 1;
+					backgroundCount -= 1;
+				}
+				x -= 1;
+			}
+
+			wasInsideWindow = insideWindow;
+		}
+
+		// Merge the layers with the priority rules described in LCDController::run, then resolve the colors into the back buffer
+		if (draw) {
+			uint8_t indices[LCD_WIDTH];
+			composeLine(backgroundLayer, objectLayer, indices, backgroundDisplay, !cgbMode && !backgroundDisplay);
+			writeLine(indices, lineColors, m_buffers[m_backBuffer] + line * LCD_WIDTH * m_pixelSize, m_pixelSize);
 		}
+		return dots;
 	}
 
 	// Tell whether the emulator can skip running this component for the cycle, to save a context commutation if running it is useless
 	bool LCDController::skip() {
+		m_clock += 1;
+		// The PPU is not resumed at all while the LCD is disabled
+		if (!m_lcdControl->displayEnable) {
+			if (!m_displayStopped)
+				stopDisplay();
+			return true;
+		}
+
 		if (m_cyclesToSkip > 0) {
-			m_cyclesToSkip -= 1;
+			// A register the rendering depends on has been written while waiting for the end of a scanline rendered ahead of time :
+			// resume the PPU right away to render it again up to that point with the previous values, then continue dot by dot
+			// The CPU runs before the PPU on each clock, so the PPU resumes on the same clock as the write
+			if (m_renderMode == RenderMode::Waiting && lineChanged()) {
+				m_renderMode = RenderMode::Replay;
+				m_lineWrite = m_clock - m_lineStart;
+				m_lineClocks = 0;
+				m_cyclesToSkip = 0;
+			} else {
+				m_cyclesToSkip -= 1;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Tell in how many clocks the component needs to be resumed
+	// skip() is checked at every clock, but in double-speed mode the PPU is only resumed on even sequencer values
+	int LCDController::nextEvent() {
+		if (!m_lcdControl->displayEnable)
+			return NO_EVENT;
+
+		int clocks = m_cyclesToSkip + 1;
+		if (m_hardware->doubleSpeed() && ((m_hardware->getSequencer() + clocks) & 1))
+			clocks += 1;
+		return clocks;
+	}
+
+	// Account for the given amount of clocks, as if skip() had been called on each of them
+	void LCDController::fastForward(int clocks) {
+		m_clock += clocks;
+		m_cyclesToSkip = (m_cyclesToSkip > clocks ? m_cyclesToSkip - clocks : 0);
+	}
+
+	// Start mode 2 or 3 of a scanline
+	// Most scanlines are not affected by any register write during mode 3, so they are rendered right away without suspending the PPU,
+	// then the PPU waits for the whole duration of mode 3 at once. If a register that affects the rendering changes in the meantime,
+	// the scanline is rendered again from the start with the registers as they were, up to the write, then continues clock by clock as usual.
+	// VRAM, OAM and CGB palettes are not accessible to the CPU during mode 3, so only the LCDC, SCX, SCY, BGP, OBP0, OBP1, WY and WX registers are concerned
+	void LCDController::startLine() {
+		// PPU memory access is frozen in STOP mode, and the bootrom may switch the operation mode, so just render everything clock by clock in those cases
+		if (m_hardware->isStopped() || !m_hardware->bootromUnmapped()) {
+			m_renderMode = RenderMode::Dots;
+			return;
+		}
+
+		m_renderMode = RenderMode::Batch;
+		m_lineStart = m_clock;
+		m_lineClocks = 0;
+		m_lineDoubleSpeed = m_hardware->doubleSpeed();
+		*m_lineControl = *m_lcdControl;
+		*m_linePalette = *m_dmgPalette;
+	}
+
+	// Account for a wait of the given amount of clocks in the PPU coroutine, returns whether the coroutine must actually be suspended
+	// In double-speed mode the PPU is only resumed on even clocks, so waits may last one clock more
+	bool LCDController::waitClocks(int clocks) {
+		if (m_renderMode == RenderMode::Dots) {
+			m_cyclesToSkip = clocks - 1;
 			return true;
 		}
-		// Skip if the PPU and LCD are disabled
-		return !m_lcdControl->displayEnable;
+
+		int target = m_lineClocks + clocks;
+		if (m_lineDoubleSpeed && (target & 1))
+			target += 1;
+
+		// Replaying the scanline : the PPU catches up with the clocks that passed before the register write, with the previous values
+		// From the first resume on or after the write, it uses the actual registers and goes on clock by clock
+		if (m_renderMode == RenderMode::Replay && target >= m_lineWrite) {
+			swapLineRegisters();
+			m_renderMode = RenderMode::Dots;
+
+			int elapsed = m_clock - m_lineStart;  // May be after the write, if the write disabled the LCD
+			if (target <= elapsed)
+				return false;
+			m_cyclesToSkip = target - elapsed - 1;
+			return true;
+		}
+
+		m_lineClocks = target;
+		return false;
 	}
 
-	// Return a full pixel buffer in RGB555 format
-	uint16_t* LCDController::pixels() {
-		return m_frontBuffer;
+	// Tell whether anything the scanline rendering depends on has changed since the start of mode 3
+	bool LCDController::lineChanged() {
+		return m_lcdControl->renderWrites != m_lineControl->renderWrites ||
+		       m_dmgPalette->renderWrites != m_linePalette->renderWrites ||
+		       m_hardware->doubleSpeed() != m_lineDoubleSpeed;
+	}
+
+	// Exchange the actual registers with the copies made at the start of mode 3
+	void LCDController::swapLineRegisters() {
+		std::swap(*m_lcdControl, *m_lineControl);
+		std::swap(*m_dmgPalette, *m_linePalette);
+	}
+
+	// Put the PPU to rest when the LCD is disabled, on the same clock as the LCDC write (LY and STAT are reset by LCDControlMapping)
+	// Any pending wait is cancelled, and the coroutine drops the current frame when it is resumed after the LCD is enabled again,
+	// so that it starts right away with line 0. Until then, the PPU does not reserve any memory and is never resumed
+	void LCDController::stopDisplay() {
+		m_displayStopped = true;
+		m_cyclesToSkip = 0;
+		m_renderMode = RenderMode::Dots;
+
+		// PPU memory access is frozen when in STOP mode
+		if (!m_hardware->isStopped()) {
+			m_oamMapping->accessible = true;
+			m_vramMapping->accessible = true;
+			if (m_cgbPalette != nullptr)
+				m_cgbPalette->accessible = true;
+		}
+	}
+
+	// Tell whether a new frame has been published since the last call to pixels()
+	bool LCDController::hasNewFrame() const {
+		return m_sharedBuffer.load(std::memory_order_relaxed) & FRAMEBUFFER_READY_FLAG;
+	}
+
+	// Return the latest complete frame in the host pixel format, the PPU never writes into it until the next call
+	// Only one thread may consume the frames
+	uint8_t* LCDController::pixels() {
+		if (hasNewFrame())
+			m_frontBuffer = m_sharedBuffer.exchange(m_frontBuffer, std::memory_order_acq_rel) & FRAMEBUFFER_INDEX_MASK;
+		return m_buffers[m_frontBuffer];
+	}
+
+	// Return the pixel format of the frames
+	PixelFormat LCDController::pixelFormat() const {
+		return m_pixelFormat;
+	}
+
+	// Return the number of the frame last returned by pixels(), to tell whether frames have been dropped in-between
+	uint64_t LCDController::pixelsFrame() const {
+		return m_bufferFrames[m_frontBuffer];
+	}
+
+	// Return the number of frames that have been rendered since startup
+	uint64_t LCDController::frameCount() const {
+		return m_frameCount;
+	}
+
+	// Only draw 1 frame out of frameSkip, or only the requested ones if it is 0. Takes effect from the next frame
+	void LCDController::setFrameSkip(int frameSkip) {
+		m_frameSkip = frameSkip;
+	}
+
+	// Draw the next frame, even if it would be skipped
+	void LCDController::requestFrame() {
+		m_frameRequested.store(true, std::memory_order_relaxed);
 	}
 
 
@@ -607,12 +1093,69 @@ namespace toygb {
 	}
 
 
-	// LCDController::Pixel
+	////////// LCDController::Pixel
+	// Background pixels use reserved values : palette = 0xF for BACKGROUND_PALETTE, object index = 0x3F for BACKGROUND_INDEX
+
+	LCDController::Pixel::Pixel() {
+		m_data = 0;
+	}
 
 	LCDController::Pixel::Pixel(uint8_t pcolor, uint8_t ppalette, uint16_t paddress, bool ppriority) {
-		color = pcolor;
-		palette = ppalette;
-		oamAddress = paddress;
-		priority = ppriority;
+		uint8_t paletteBits = (ppalette == BACKGROUND_PALETTE ? 0xF : ppalette & 0xF);
+		uint8_t objectBits = (paddress == BACKGROUND_INDEX ? 0x3F : (paddress >> 2) & 0x3F);
+		m_data = (pcolor & 3) | (ppriority << 2) | (paletteBits << 3) | (objectBits << 7);
+	}
+
+	uint8_t LCDController::Pixel::color() const {
+		return m_data & 3;
+	}
+
+	uint8_t LCDController::Pixel::palette() const {
+		uint8_t paletteBits = (m_data >> 3) & 0xF;
+		return (paletteBits == 0xF ? BACKGROUND_PALETTE : paletteBits);
+	}
+
+	uint16_t LCDController::Pixel::oamAddress() const {
+		uint8_t objectBits = (m_data >> 7) & 0x3F;
+		return (objectBits == 0x3F ? BACKGROUND_INDEX : objectBits << 2);
+	}
+
+	uint8_t LCDController::Pixel::priority() const {
+		return (m_data >> 2) & 1;
+	}
+
+
+	////////// LCDController::PixelFIFO
+	// Fixed-size ring buffer, the PPU never holds more than 16 pixels in a FIFO so there is no need to check for overflows
+
+	LCDController::PixelFIFO::PixelFIFO() {
+		m_start = 0;
+		m_size = 0;
+	}
+
+	bool LCDController::PixelFIFO::empty() const {
+		return m_size == 0;
+	}
+
+	// Return the first pixel of the FIFO, without removing it
+	LCDController::Pixel LCDController::PixelFIFO::front() const {
+		return m_pixels[m_start];
+	}
+
+	// Add a pixel at the end of the FIFO
+	void LCDController::PixelFIFO::push(LCDController::Pixel pixel) {
+		m_pixels[(m_start + m_size) & (PIXEL_FIFO_SIZE - 1)] = pixel;
+		m_size += 1;
+	}
+
+	// Remove the first pixel of the FIFO
+	void LCDController::PixelFIFO::pop() {
+		m_start = (m_start + 1) & (PIXEL_FIFO_SIZE - 1);
+		m_size -= 1;
+	}
+
+	void LCDController::PixelFIFO::clear() {
+		m_start = 0;
+		m_size = 0;
 	}
 }
@@ -0,0 +1,227 @@
+#include "graphics/LineKernels.hpp"
+#include "graphics/PixelFormat.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+	#include <immintrin.h>
+	#define X86_KERNELS
+#endif
+
+/** Tile row decoding and line composition kernels
+Those operations are the same on every pixel, so on x86 they are also implemented with SSE2 and AVX2 instructions,
+compiled for those instruction sets regardless of the build flags. The fastest set the CPU supports is selected when the program starts.
+
+Line composition works on the whole line at once : the renderer puts the background / window and objects pixels into a byte each,
+then composeLine resolves the priorities to get an index in a table of the 64 colors of the line (+ blank) in the host format,
+and writeLine looks the colors up into the pixel buffer. */
+
+
+namespace toygb {
+	////////// Portable implementations
+
+	static void decodeTileRowsScalar(const uint8_t* data, uint8_t* normal, uint8_t* flipped) {
+		// Each row is in two bytes, bits of each byte are interleaved to build the 2-bits color index. Indices are the x coordinate within the tile :
+		// Upper byte : u0 u1 u2 u3 u4 u5 u6 u7 |
+		// Lower byte : l0 l1 l2 l3 l4 l5 l6 l7 | -> u0l0 u1l1 u2l2 u3l3 u4l4 u5l5 u6l6 u7l7
+		for (int row = 0; row < 8; row++) {
+			uint8_t tileLow = data[row * 2];
+			uint8_t tileHigh = data[row * 2 + 1];  // (Little endian, upper byte is second)
+			for (int i = 0; i < 8; i++) {
+				uint8_t color = (((tileHigh >> (7 - i)) & 1) << 1) | ((tileLow >> (7 - i)) & 1);
+				normal[row * 8 + i] = color;
+				flipped[row * 8 + 7 - i] = color;
+			}
+		}
+	}
+
+	static void composeLineScalar(const uint8_t* background, const uint8_t* objects, uint8_t* indices, bool backgroundDisplay, bool blankBackground) {
+		for (int x = 0; x < LINE_PIXELS; x++) {
+			uint8_t backgroundPixel = background[x];
+			uint8_t objectPixel = objects[x];
+			bool objectHasPriority = (objectPixel & 3) != 0 && (!backgroundDisplay || (backgroundPixel & 3) == 0 || ((backgroundPixel | objectPixel) & LAYER_PRIORITY) == 0);
+			if (objectHasPriority)
+				indices[x] = LINE_COLORS_OBJECTS + (objectPixel & LAYER_INDEX_MASK);
+			else if (blankBackground)
+				indices[x] = LINE_COLORS_BLANK;
+			else
+				indices[x] = LINE_COLORS_BACKGROUND + (backgroundPixel & LAYER_INDEX_MASK);
+		}
+	}
+
+	static void writeLineScalar(const uint8_t* indices, const uint32_t* colors, uint8_t* output, int pixelSize) {
+		if (pixelSize == 4) {
+			for (int x = 0; x < LINE_PIXELS; x++)
+				writePixel(output, x, colors[indices[x]], 4);
+		} else {
+			for (int x = 0; x < LINE_PIXELS; x++)
+				writePixel(output, x, colors[indices[x]], 2);
+		}
+	}
+
+#ifdef X86_KERNELS
+	////////// SSE2 implementations
+
+	// Masks to test the bits of a row byte broadcast over 8 bytes, from the leftmost pixel (bit 7) to the rightmost (bit 0), and the other way round
+	static const uint64_t PIXEL_BITS = 0x0102040810204080ULL;
+	static const uint64_t PIXEL_BITS_FLIPPED = 0x8040201008040201ULL;
+	// Multiplying a byte by this broadcasts it over 8 bytes
+	static const uint64_t BROADCAST = 0x0101010101010101ULL;
+
+	__attribute__((target("sse2")))
+	static void decodeTileRowsSSE2(const uint8_t* data, uint8_t* normal, uint8_t* flipped) {
+		const __m128i bits = _mm_set1_epi64x(PIXEL_BITS);
+		const __m128i bitsFlipped = _mm_set1_epi64x(PIXEL_BITS_FLIPPED);
+		const __m128i one = _mm_set1_epi8(1);
+		const __m128i two = _mm_set1_epi8(2);
+
+		// Two rows at once : each byte of the row is broadcast over the 8 pixels, then each pixel keeps its own bit
+		for (int row = 0; row < 8; row += 2) {
+			__m128i low = _mm_set_epi64x(data[row * 2 + 2] * BROADCAST, data[row * 2] * BROADCAST);
+			__m128i high = _mm_set_epi64x(data[row * 2 + 3] * BROADCAST, data[row * 2 + 1] * BROADCAST);
+
+			__m128i color = _mm_or_si128(_mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(low, bits), bits), one),
+			                             _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(high, bits), bits), two));
+			__m128i colorFlipped = _mm_or_si128(_mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(low, bitsFlipped), bitsFlipped), one),
+			                                    _mm_and_si128(_mm_cmpeq_epi8(_mm_and_si128(high, bitsFlipped), bitsFlipped), two));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(normal + row * 8), color);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(flipped + row * 8), colorFlipped);
+		}
+	}
+
+	__attribute__((target("sse2")))
+	static void composeLineSSE2(const uint8_t* background, const uint8_t* objects, uint8_t* indices, bool backgroundDisplay, bool blankBackground) {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i colorMask = _mm_set1_epi8(3);
+		const __m128i indexMask = _mm_set1_epi8(LAYER_INDEX_MASK);
+		const __m128i priorityMask = _mm_set1_epi8((char)LAYER_PRIORITY);
+		const __m128i objectsOffset = _mm_set1_epi8(LINE_COLORS_OBJECTS);
+		const __m128i blank = _mm_set1_epi8(LINE_COLORS_BLANK);
+		const __m128i backgroundHidden = _mm_set1_epi8(backgroundDisplay ? 0 : -1);
+
+		for (int x = 0; x < LINE_PIXELS; x += 16) {
+			__m128i backgroundPixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(background + x));
+			__m128i objectPixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(objects + x));
+
+			// Same as the scalar condition, as masks : object color != 0 && (!LCDC.0 || background color == 0 || no priority bit)
+			__m128i objectTransparent = _mm_cmpeq_epi8(_mm_and_si128(objectPixels, colorMask), zero);
+			__m128i backgroundZero = _mm_cmpeq_epi8(_mm_and_si128(backgroundPixels, colorMask), zero);
+			__m128i noPriority = _mm_cmpeq_epi8(_mm_and_si128(_mm_or_si128(backgroundPixels, objectPixels), priorityMask), zero);
+			__m128i objectHasPriority = _mm_andnot_si128(objectTransparent, _mm_or_si128(backgroundHidden, _mm_or_si128(backgroundZero, noPriority)));
+
+			__m128i objectIndex = _mm_add_epi8(_mm_and_si128(objectPixels, indexMask), objectsOffset);
+			__m128i backgroundIndex = (blankBackground ? blank : _mm_and_si128(backgroundPixels, indexMask));
+			__m128i result = _mm_or_si128(_mm_and_si128(objectHasPriority, objectIndex), _mm_andnot_si128(objectHasPriority, backgroundIndex));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(indices + x), result);
+		}
+	}
+
+	////////// AVX2 implementations
+
+	__attribute__((target("avx2")))
+	static void composeLineAVX2(const uint8_t* background, const uint8_t* objects, uint8_t* indices, bool backgroundDisplay, bool blankBackground) {
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i colorMask = _mm256_set1_epi8(3);
+		const __m256i indexMask = _mm256_set1_epi8(LAYER_INDEX_MASK);
+		const __m256i priorityMask = _mm256_set1_epi8((char)LAYER_PRIORITY);
+		const __m256i objectsOffset = _mm256_set1_epi8(LINE_COLORS_OBJECTS);
+		const __m256i blank = _mm256_set1_epi8(LINE_COLORS_BLANK);
+		const __m256i backgroundHidden = _mm256_set1_epi8(backgroundDisplay ? 0 : -1);
+
+		// Same as SSE2, 32 pixels at once (160 = 5 * 32)
+		for (int x = 0; x < LINE_PIXELS; x += 32) {
+			__m256i backgroundPixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(background + x));
+			__m256i objectPixels = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(objects + x));
+
+			__m256i objectTransparent = _mm256_cmpeq_epi8(_mm256_and_si256(objectPixels, colorMask), zero);
+			__m256i backgroundZero = _mm256_cmpeq_epi8(_mm256_and_si256(backgroundPixels, colorMask), zero);
+			__m256i noPriority = _mm256_cmpeq_epi8(_mm256_and_si256(_mm256_or_si256(backgroundPixels, objectPixels), priorityMask), zero);
+			__m256i objectHasPriority = _mm256_andnot_si256(objectTransparent, _mm256_or_si256(backgroundHidden, _mm256_or_si256(backgroundZero, noPriority)));
+
+			__m256i objectIndex = _mm256_add_epi8(_mm256_and_si256(objectPixels, indexMask), objectsOffset);
+			__m256i backgroundIndex = (blankBackground ? blank : _mm256_and_si256(backgroundPixels, indexMask));
+			__m256i result = _mm256_blendv_epi8(backgroundIndex, objectIndex, objectHasPriority);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(indices + x), result);
+		}
+	}
+
+	// The colors are looked up 8 at a time with gather instructions
+	__attribute__((target("avx2")))
+	static void writeLineAVX2(const uint8_t* indices, const uint32_t* colors, uint8_t* output, int pixelSize) {
+		const int* table = reinterpret_cast<const int*>(colors);
+		if (pixelSize == 4) {
+			for (int x = 0; x < LINE_PIXELS; x += 8) {
+				__m256i lineIndices = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(indices + x)));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(output + 4*x), _mm256_i32gather_epi32(table, lineIndices, 4));
+			}
+		} else {
+			// 16-bits colors are gathered as 32 bits values then packed, packus works within each 128-bits half so the result must be reordered
+			for (int x = 0; x < LINE_PIXELS; x += 16) {
+				__m256i first = _mm256_i32gather_epi32(table, _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(indices + x))), 4);
+				__m256i second = _mm256_i32gather_epi32(table, _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(indices + x + 8))), 4);
+				__m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(first, second), 0b11011000);
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(output + 2*x), packed);
+			}
+		}
+	}
+#endif
+
+	////////// Runtime selection
+
+	static void (*s_decodeTileRows)(const uint8_t*, uint8_t*, uint8_t*) = decodeTileRowsScalar;
+	static void (*s_composeLine)(const uint8_t*, const uint8_t*, uint8_t*, bool, bool) = composeLineScalar;
+	static void (*s_writeLine)(const uint8_t*, const uint32_t*, uint8_t*, int) = writeLineScalar;
+
+	// Get the fastest kernel set supported by the host CPU
+	KernelSet bestKernelSet() {
+		#ifdef X86_KERNELS
+			__builtin_cpu_init();
+			if (__builtin_cpu_supports("avx2"))
+				return KernelSet::AVX2;
+			if (__builtin_cpu_supports("sse2"))
+				return KernelSet::SSE2;
+		#endif
+		return KernelSet::Scalar;
+	}
+
+	// Select the kernel implementations to use
+	// SSE2 has no gather instruction, so writeLine stays scalar with SSE2
+	// Tile rows are decoded with SSE2 in both cases : the rows have to be spread over the vector one by one, which costs more than it saves with 256-bits vectors
+	void useKernelSet(KernelSet set) {
+		switch (set) {
+			case KernelSet::Scalar:
+				s_decodeTileRows = decodeTileRowsScalar;
+				s_composeLine = composeLineScalar;
+				s_writeLine = writeLineScalar;
+				break;
+			#ifdef X86_KERNELS
+			case KernelSet::SSE2:
+				s_decodeTileRows = decodeTileRowsSSE2;
+				s_composeLine = composeLineSSE2;
+				s_writeLine = writeLineScalar;
+				break;
+			case KernelSet::AVX2:
+				s_decodeTileRows = decodeTileRowsSSE2;
+				s_composeLine = composeLineAVX2;
+				s_writeLine = writeLineAVX2;
+				break;
+			#else
+			default:
+				break;
+			#endif
+		}
+	}
+
+	// Select the best kernels at startup
+	static const bool s_kernelsSelected = (useKernelSet(bestKernelSet()), true);
+
+	void decodeTileRows(const uint8_t* data, uint8_t* normal, uint8_t* flipped) {
+		s_decodeTileRows(data, normal, flipped);
+	}
+
+	void composeLine(const uint8_t* background, const uint8_t* objects, uint8_t* indices, bool backgroundDisplay, bool blankBackground) {
+		s_composeLine(background, objects, indices, backgroundDisplay, blankBackground);
+	}
+
+	void writeLine(const uint8_t* indices, const uint32_t* colors, uint8_t* output, int pixelSize) {
+		s_writeLine(indices, colors, output, pixelSize);
+	}
+}
@@ -0,0 +1,97 @@
+#include "graphics/ObjectLineCache.hpp"
+
+/** Per-scanline object selection
+The OAM scan selects the first 10 objects in OAM order that cover the scanline, then the PPU renders them in order of increasing X coordinate.
+Objects rarely move compared to how often the scan runs, so each scanline keeps a bitmap of the objects that cover it, updated when their Y
+coordinate changes, and its sorted selection is only computed again when an object on it has moved. Changing the object size rebuilds everything. */
+
+
+namespace toygb {
+	// Possible objects heights, defined by LCDC.2, in pixels
+	static const int OBJECT_HEIGHT[] = {8, 16};
+
+	// Initialize the cache from the current OAM contents
+	ObjectLineCache::ObjectLineCache(const uint8_t* oam) {
+		m_oam = oam;
+		build(false);
+	}
+
+	// Get the selected objects on a scanline, sorting them again if necessary
+	int ObjectLineCache::lineObjects(int line, bool objectSize, uint16_t* objects) {
+		if (objectSize != m_objectSize)
+			build(objectSize);
+		if (m_lineDirty[line])
+			sortLine(line);
+
+		for (int i = 0; i < m_lineCounts[line]; i++)
+			objects[i] = m_lineObjects[line][i];
+		return m_lineCounts[line];
+	}
+
+	// Register all objects on their scanlines for the given object size
+	void ObjectLineCache::build(bool objectSize) {
+		m_objectSize = objectSize;
+		for (int line = 0; line < OBJECT_LINES; line++) {
+			m_lineMasks[line] = 0;
+			m_lineDirty[line] = true;
+		}
+
+		int height = OBJECT_HEIGHT[objectSize];
+		for (int object = 0; object < OAM_OBJECTS; object++) {
+			// The position in OAM is Y + 16, objects with Y < 16 wrap around and are not on any scanline
+			uint8_t yposition = m_oam[object * 4] - 16;
+			m_objectY[object] = yposition;
+			for (int line = yposition; line < yposition + height && line < OBJECT_LINES; line++)
+				m_lineMasks[line] |= uint64_t(1) << object;
+		}
+	}
+
+	// Move an object to the scanlines of its new Y coordinate
+	void ObjectLineCache::moveObject(int object) {
+		int height = OBJECT_HEIGHT[m_objectSize];
+		uint64_t bit = uint64_t(1) << object;
+
+		uint8_t previous = m_objectY[object];
+		for (int line = previous; line < previous + height && line < OBJECT_LINES; line++) {
+			m_lineMasks[line] &= ~bit;
+			m_lineDirty[line] = true;
+		}
+
+		uint8_t yposition = m_oam[object * 4] - 16;
+		m_objectY[object] = yposition;
+		for (int line = yposition; line < yposition + height && line < OBJECT_LINES; line++) {
+			m_lineMasks[line] |= bit;
+			m_lineDirty[line] = true;
+		}
+	}
+
+	// Mark the scanlines an object is on to be sorted again, when its X coordinate changes
+	void ObjectLineCache::markLines(int object) {
+		uint8_t yposition = m_objectY[object];
+		for (int line = yposition; line < yposition + OBJECT_HEIGHT[m_objectSize] && line < OBJECT_LINES; line++)
+			m_lineDirty[line] = true;
+	}
+
+	// Select the objects of a scanline and sort them by X coordinate
+	// Objects with the same X coordinate stay in OAM order, as with the small-range insertion sort std::sort uses in the OAM scan
+	void ObjectLineCache::sortLine(int line) {
+		uint64_t mask = m_lineMasks[line];
+		uint16_t* objects = m_lineObjects[line];
+		int count = 0;
+		while (mask != 0 && count < MAX_LINE_OBJECTS) {
+			uint16_t address = std::countr_zero(mask) * 4;
+			mask &= mask - 1;
+
+			int position = count;
+			while (position > 0 && m_oam[objects[position - 1] + 1] > m_oam[address + 1]) {
+				objects[position] = objects[position - 1];
+				position -= 1;
+			}
+			objects[position] = address;
+			count += 1;
+		}
+
+		m_lineCounts[line] = count;
+		m_lineDirty[line] = false;
+	}
+}
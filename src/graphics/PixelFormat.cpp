@@ -0,0 +1,53 @@
+#include "graphics/PixelFormat.hpp"
+
+/** Host pixel formats
+The PPU resolves colors as RGB555 values (as in CGB palettes), that are converted into the host format
+when the palettes are written, so that the rendered frames can be handed over to the interface as-is.
+The conversion from 5 to 8 bits per component is the same as the original interface,
+and the 6-bits green of RGB565 repeats its most significant bit. */
+
+
+namespace toygb {
+	// Return the size of a pixel in the given format
+	int pixelSize(PixelFormat format) {
+		switch (format) {
+			case PixelFormat::RGBA8888:
+			case PixelFormat::BGRA8888:
+				return 4;
+			case PixelFormat::RGB565:
+				return 2;
+		}
+		return 4;
+	}
+
+	// Convert an RGB555 color into the given format
+	// 32-bits formats are built byte by byte so that their layout in memory does not depend on the host endianness
+	uint32_t hostColor(uint16_t color, PixelFormat format) {
+		uint8_t red = color & 0x1F;
+		uint8_t green = (color >> 5) & 0x1F;
+		uint8_t blue = (color >> 10) & 0x1F;
+
+		uint8_t bytes[4];
+		uint32_t result = 0;
+		switch (format) {
+			case PixelFormat::RGBA8888:
+				bytes[0] = (red << 3) + 0b101;
+				bytes[1] = (green << 3) + 0b101;
+				bytes[2] = (blue << 3) + 0b101;
+				bytes[3] = 255;
+				std::memcpy(&result, bytes, 4);
+				break;
+			case PixelFormat::BGRA8888:
+				bytes[0] = (blue << 3) + 0b101;
+				bytes[1] = (green << 3) + 0b101;
+				bytes[2] = (red << 3) + 0b101;
+				bytes[3] = 255;
+				std::memcpy(&result, bytes, 4);
+				break;
+			case PixelFormat::RGB565:
+				result = (red << 11) | (green << 6) | ((green >> 4) << 5) | blue;
+				break;
+		}
+		return result;
+	}
+}
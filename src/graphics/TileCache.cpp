@@ -0,0 +1,33 @@
+#include "graphics/TileCache.hpp"
+#include "graphics/LineKernels.hpp"
+
+/** Decoded tile data cache
+Tile rows are stored in VRAM as 2 bytes, that must be interleaved bit by bit to get the 2-bits color index of each pixel.
+Games rarely write into the tile data compared to how often the PPU reads it, so the rows are decoded once into one byte per pixel,
+in both horizontal orientations, and the PPU only has to copy or read them. A write into the tile data marks the whole tile for decoding again. */
+
+
+namespace toygb {
+	// Initialize the cache, with all tiles to be decoded on their first use
+	TileCache::TileCache(const uint8_t* vram, int banks) {
+		m_vram = vram;
+		m_tiles = banks * TILES_PER_BANK;
+		m_rows = new uint8_t[m_tiles * 2 * 8 * 8];
+		m_dirty = new bool[m_tiles];
+		for (int i = 0; i < m_tiles; i++)
+			m_dirty[i] = true;
+	}
+
+	TileCache::~TileCache() {
+		delete[] m_rows;
+		delete[] m_dirty;
+	}
+
+	// Decode all rows of the given tile from VRAM
+	void TileCache::decode(int tile) {
+		const uint8_t* data = m_vram + (tile / TILES_PER_BANK) * VRAM_BANK_SIZE + (tile % TILES_PER_BANK) * TILE_SIZE;
+		uint8_t* normal = m_rows + tile * 2 * 8 * 8;
+		decodeTileRows(data, normal, normal + 8 * 8);
+		m_dirty[tile] = false;
+	}
+}
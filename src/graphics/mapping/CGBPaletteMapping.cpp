@@ -32,8 +32,9 @@ Abs. addr. | Rel. addr. | Name | Access   | Content
 
 namespace toygb {
 	// Initialize the memory with its initial values
-	CGBPaletteMapping::CGBPaletteMapping(HardwareStatus* hardware) {
+	CGBPaletteMapping::CGBPaletteMapping(HardwareStatus* hardware, PixelFormat format) {
 		m_hardware = hardware;
+		m_format = format;
 		accessible = true;
 
 		objectIndex = 0x3F;
@@ -46,6 +47,11 @@ namespace toygb {
 		for (int i = 0; i < 8; i++)
 			backgroundPalettes[i] = 0x7FFF;
 
+		for (int i = 0; i < 8*4; i++) {
+			objectColors[i] = hostColor(objectPalettes[i], m_format);
+			backgroundColors[i] = hostColor(backgroundPalettes[i], m_format);
+		}
+
 		objectPriority = false;
 	}
 
@@ -95,6 +101,7 @@ namespace toygb {
 						backgroundPalettes[colorIndex] = (backgroundPalettes[colorIndex] & 0x00FF) | (value << 8);
 					else
 						backgroundPalettes[colorIndex] = (backgroundPalettes[colorIndex] & 0xFF00) | value;
+					backgroundColors[colorIndex] = hostColor(backgroundPalettes[colorIndex], m_format);
 
 					if (backgroundAutoIncrement)
 						backgroundIndex = (backgroundIndex + 1) & 0x3F;
@@ -110,6 +117,7 @@ namespace toygb {
 						objectPalettes[colorIndex] = (objectPalettes[colorIndex] & 0x00FF) | (value << 8);
 					else
 						objectPalettes[colorIndex] = (objectPalettes[colorIndex] & 0xFF00) | value;
+					objectColors[colorIndex] = hostColor(objectPalettes[colorIndex], m_format);
 
 					if (objectAutoIncrement)
 						objectIndex = (objectIndex + 1) & 0x3F;
@@ -23,8 +23,14 @@ Abs. addr. | Rel. addr. | Name | Access   | Content
 
 
 namespace toygb {
+	// Default RGB555 color values for DMG colors
+	const uint16_t DMG_PALETTE[] = {0x6318, 0x4A52, 0x2108, 0x18C6};
+
 	// Initialize the memory mapping with its initial values
-	DMGPaletteMapping::DMGPaletteMapping() {
+	DMGPaletteMapping::DMGPaletteMapping(PixelFormat format) {
+		for (int i = 0; i < 4; i++)
+			m_shades[i] = hostColor(DMG_PALETTE[i], format);
+
 		// Monochrome palettes
 		backgroundPalette[0] = 3;
 		backgroundPalette[1] = 3;
@@ -43,8 +49,14 @@ namespace toygb {
 		objectPalette1[2] = 3;
 		objectPalette1[3] = 3;
 
+		updateColors(backgroundColors, backgroundPalette);
+		updateColors(objectColors0, objectPalette0);
+		updateColors(objectColors1, objectPalette1);
+
 		windowX = 0x00;
 		windowY = 0x00;
+
+		renderWrites = 0;
 	}
 
 	// Get the value at the given relative address
@@ -78,27 +90,39 @@ namespace toygb {
 
 	// Set the value at the given memory address
 	void DMGPaletteMapping::set(uint16_t address, uint8_t value) {
+		if (get(address) != value)
+			renderWrites += 1;
+
 		switch (address) {
 			case OFFSET_BGPALETTE:
 				backgroundPalette[0] = value & 3;
 				backgroundPalette[1] = (value >> 2) & 3;
 				backgroundPalette[2] = (value >> 4) & 3;
 				backgroundPalette[3] = (value >> 6) & 3;
+				updateColors(backgroundColors, backgroundPalette);
 				break;
 			case OFFSET_OBJ0PALETTE:
 				objectPalette0[0] = value & 3;
 				objectPalette0[1] = (value >> 2) & 3;
 				objectPalette0[2] = (value >> 4) & 3;
 				objectPalette0[3] = (value >> 6) & 3;
+				updateColors(objectColors0, objectPalette0);
 				break;
 			case OFFSET_OBJ1PALETTE:
 				objectPalette1[0] = value & 3;
 				objectPalette1[1] = (value >> 2) & 3;
 				objectPalette1[2] = (value >> 4) & 3;
 				objectPalette1[3] = (value >> 6) & 3;
+				updateColors(objectColors1, objectPalette1);
 				break;
 			case OFFSET_WINDOWY: windowY = value; break;
 			case OFFSET_WINDOWX: windowX = value; break;
 		}
 	}
+
+	// Resolve the host-format colors of a monochrome palette
+	void DMGPaletteMapping::updateColors(uint32_t* colors, uint8_t* palette) {
+		for (int i = 0; i < 4; i++)
+			colors[i] = m_shades[palette[i]];
+	}
 }
@@ -3,7 +3,7 @@
 
 namespace toygb {
 	// Initialize the memory mapping
-	LCDBankedMemoryMapping::LCDBankedMemoryMapping(uint8_t* bankSelect, uint16_t bankSize, uint8_t* array) : LCDMemoryMapping(array) {
+	LCDBankedMemoryMapping::LCDBankedMemoryMapping(uint8_t* bankSelect, uint16_t bankSize, uint8_t* array, TileCache* tileCache) : LCDMemoryMapping(array, tileCache) {
 		accessible = true;
 		m_bankSelect = bankSelect;
 		m_bankSize = bankSize;
@@ -18,8 +18,12 @@ namespace toygb {
 
 	// Set the value at the given memory address (CPU access, unavailable if reserved by the PPU)
 	void LCDBankedMemoryMapping::set(uint16_t address, uint8_t value) {
-		if (accessible)
-			m_array[address + (*m_bankSelect * m_bankSize)] = value;
+		uint16_t index = address + (*m_bankSelect * m_bankSize);
+		if (accessible && m_array[index] != value) {
+			m_array[index] = value;
+			if (m_tileCache != nullptr)
+				m_tileCache->invalidate(index);
+		}
 	}
 
 	// Get the value at the given memory address (regardless of bank switching) (PPU access, unavailable if not reserved)
@@ -30,7 +34,10 @@ namespace toygb {
 
 	// Set the value at the given index (regardless of bank switching) (PPU access, unavailable if reserved by the PPU)
 	void LCDBankedMemoryMapping::lcdSet(uint16_t address, uint8_t value) {
-		if (!accessible)
+		if (!accessible && m_array[address] != value) {
 			m_array[address] = value;
+			if (m_tileCache != nullptr)
+				m_tileCache->invalidate(address);
+		}
 	}
 }
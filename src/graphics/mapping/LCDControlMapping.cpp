@@ -66,6 +66,8 @@ namespace toygb {
 		// Coordinate
 		coordY = 0x00;
 		coordYCompare = 0x00;
+
+		renderWrites = 0;
 	}
 
 	// Get the value at the given relative address
@@ -105,9 +107,12 @@ namespace toygb {
 
 	// Set the value at the given relative address
 	void LCDControlMapping::set(uint16_t address, uint8_t value) {
+		if ((address == OFFSET_CONTROL || address == OFFSET_SCROLLX || address == OFFSET_SCROLLY) && get(address) != value)
+			renderWrites += 1;
+
 		switch (address) {
 			case OFFSET_CONTROL:  // LCDC
-				if (displayEnable && ((value >> 7) & 1))
+				if (displayEnable && !((value >> 7) & 1))
 					shutdownPPU();
 				displayEnable = (value >> 7) & 1;
 				windowTilemapSelect = (value >> 6) & 1;
@@ -3,9 +3,10 @@
 
 namespace toygb {
 	// Initialize the memory mapping
-	LCDMemoryMapping::LCDMemoryMapping(uint8_t* array) {
+	LCDMemoryMapping::LCDMemoryMapping(uint8_t* array, TileCache* tileCache) {
 		accessible = true;
 		m_array = array;
+		m_tileCache = tileCache;
 	}
 
 	// Get the value at the given memory address (CPU access, unavailable if reserved by the PPU)
@@ -16,8 +17,11 @@ namespace toygb {
 
 	// Set the value at the given memory address (CPU access, unavailable if reserved by the PPU)
 	void LCDMemoryMapping::set(uint16_t address, uint8_t value) {
-		if (accessible)
+		if (accessible && m_array[address] != value) {
 			m_array[address] = value;
+			if (m_tileCache != nullptr)
+				m_tileCache->invalidate(address);
+		}
 	}
 
 	// Get the value at the given memory address (PPU access, unavailable if not reserved)
@@ -28,7 +32,10 @@ namespace toygb {
 
 	// Set the value at the given memory address (PPU access, unavailable if not reserved)
 	void LCDMemoryMapping::lcdSet(uint16_t address, uint8_t value) {
-		if (!accessible)
+		if (!accessible && m_array[address] != value) {
 			m_array[address] = value;
+			if (m_tileCache != nullptr)
+				m_tileCache->invalidate(address);
+		}
 	}
 }
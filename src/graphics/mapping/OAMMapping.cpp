@@ -14,8 +14,9 @@ This is extremely revision- and hardware-dependant, so many details are probably
 
 namespace toygb {
 	// Initialize the memory mapping
-	OAMMapping::OAMMapping(HardwareStatus* hardware, uint8_t* array) : LCDMemoryMapping(array){
+	OAMMapping::OAMMapping(HardwareStatus* hardware, uint8_t* array, ObjectLineCache* objectCache) : LCDMemoryMapping(array){
 		m_hardware = hardware;
+		m_objectCache = objectCache;
 		m_fea0 = nullptr;
 		m_fec0 = nullptr;
 		m_fee0 = nullptr;
@@ -105,7 +106,10 @@ namespace toygb {
 		if (accessible) {
 			// Normal OAM access
 			if (address < OFFSET_UNUSED) {
-				m_array[address] = value;
+				if (m_array[address] != value) {
+					m_array[address] = value;
+					m_objectCache->invalidate(address);
+				}
 			}
 
 			// Unused 0xFEA0-0xFEFF area
@@ -141,7 +145,9 @@ namespace toygb {
 
 	// Set the value at the given memory address (PPU access, unavailable if not reserved)
 	void OAMMapping::lcdSet(uint16_t address, uint8_t value) {
-		if (!accessible)
+		if (!accessible && m_array[address] != value) {
 			m_array[address] = value;
+			m_objectCache->invalidate(address);
+		}
 	}
 }
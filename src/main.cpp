@@ -5,6 +5,8 @@
 #include <stdexcept>
 #include <exception>
 #include <cstring>
+#include <cctype>
+#include <cmath>
 
 #include "Gameboy.hpp"
 #include "GameboyConfig.hpp"
@@ -89,6 +91,48 @@ ConsoleModel argumentConsole(std::string value) {
 	else throw std::runtime_error("Invalid console model (--console argument)");
 }
 
+// Decode the --filter argument, returns whether to use smooth (bilinear) scaling
+bool argumentFilter(std::string value) {
+	std::transform(value.begin(), value.end(), value.begin(),
+		[](unsigned char c){ return std::toupper(c); });
+
+	if (value == "NEAREST")       return false;
+	else if (value == "LINEAR")   return true;
+	else if (value == "BILINEAR") return true;
+	else throw std::runtime_error("Invalid scaling filter (--filter argument)");
+}
+
+// Decode the --frames and --cycles arguments, a whole number (0 = no limit)
+uint64_t argumentLimit(std::string value, std::string key) {
+	if (value.empty() || !std::all_of(value.begin(), value.end(), [](unsigned char c){ return std::isdigit(c); }))
+		throw std::runtime_error("Invalid run limit, must be a whole number, 0 or more (" + key + " argument)");
+	try {
+		return std::stoull(value);
+	} catch (std::out_of_range& err) {
+		throw std::runtime_error("Invalid run limit, value too large (" + key + " argument)");
+	}
+}
+
+// Decode the --time argument, in seconds (0 = no limit)
+double argumentTime(std::string value) {
+	std::size_t end = 0;
+	double time = -1;
+	try {
+		time = std::stod(value, &end);
+	} catch (std::logic_error& err) {}
+	if (end != value.size() || !(time >= 0) || std::isinf(time))
+		throw std::runtime_error("Invalid run time, must be a number of seconds, 0 or more (--time argument)");
+	return time;
+}
+
+// Decode the --frameskip argument
+int argumentFrameSkip(std::string value) {
+	int frameSkip = std::stoi(value);
+	if (frameSkip < 0)
+		throw std::runtime_error("Invalid frame skip count, must be 0 or more (--frameskip argument)");
+	return frameSkip;
+}
+
 int assembleFile(std::string filename, std::string outname) {
 	if (filename.empty()) {
 		std::cerr << "No input file !" << std::endl;
@@ -143,6 +187,20 @@ void printHelp(char* argv0) {
 	std::cout << "\t          AGB0, AGB-A, AGB-AE, AGB-B, AGB-BE" << std::endl;
 	std::cout << "\t          SGB, SGB2" << std::endl;
 	std::cout << "\tAliases : DMG = DMG-C, CGB = CGB-E, AGB = AGB-A, GBP = AGB-A" << std::endl;
+	std::cout << std::endl << "Run options : " << std::endl;
+	std::cout << "--headless          : Run without window nor audio output, as fast as possible" << std::endl;
+	std::cout << "--uncapped          : Run as fast as possible instead of real time" << std::endl;
+	std::cout << "--audiosync         : Keep the emulation in step with the audio output, for long sessions without audio dropouts" << std::endl;
+	std::cout << "--frames=<count>    : Stop after the given number of frames" << std::endl;
+	std::cout << "--cycles=<count>    : Stop after the given number of clock cycles (4194304 per second)" << std::endl;
+	std::cout << "--time=<seconds>    : Stop after the given real time in seconds" << std::endl;
+	std::cout << "--frameskip=<count> : Only draw 1 frame out of the given count, emulation timings are unaffected" << std::endl;
+	std::cout << "\t0 : only draw the frames requested with the F key in the window" << std::endl;
+	std::cout << "--audioout=<file>   : Run headless and write the audio output into the given file (WAV if it ends with .wav, raw 16-bits stereo PCM otherwise)" << std::endl;
+	std::cout << std::endl << "Display options : " << std::endl;
+	std::cout << "--filter=<filter>   : Filter used to scale the screen to the window" << std::endl;
+	std::cout << "\tValues  : nearest, linear (default : nearest)" << std::endl;
+	std::cout << "\tAliases : bilinear = linear" << std::endl;
 	std::cout << std::endl << "Debug options : " << std::endl;
 	std::cout << "--status : Print disassembly to console" << std::endl;
 	std::cout << std::endl << "Assemble options : " << std::endl;
@@ -187,6 +245,27 @@ int main(int argc, char** argv) {
 				config.ramfile = value;
 			} else if (key == "--bootrom") {
 				config.bootrom = value;
+			} else if (key == "--headless") {
+				config.headless = true;
+				config.uncapped = true;
+			} else if (key == "--uncapped") {
+				config.uncapped = true;
+			} else if (key == "--audiosync") {
+				config.audioSync = true;
+			} else if (key == "--frames") {
+				config.maxFrames = argumentLimit(value, key);
+			} else if (key == "--cycles") {
+				config.maxCycles = argumentLimit(value, key);
+			} else if (key == "--time") {
+				config.maxTime = argumentTime(value);
+			} else if (key == "--frameskip") {
+				config.frameSkip = argumentFrameSkip(value);
+			} else if (key == "--audioout") {
+				config.audioFile = value;
+				config.headless = true;
+				config.uncapped = true;
+			} else if (key == "--filter") {
+				config.smoothScaling = argumentFilter(value);
 			}
 			// Assembler usage
 			else if (key == "--assemble") {
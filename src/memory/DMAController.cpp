@@ -54,6 +54,14 @@ namespace toygb {
 		}
 	}
 
+	// Tell in how many clocks the component needs to run (on the next machine cycle when a DMA is requested or running)
+	int DMAController::nextEvent() {
+		if (m_oamDmaMapping->active || m_oamDmaMapping->requested)
+			return CLOCKS_TO_SEQUENCER(m_hardware->getSequencer(), 0b11);
+		else
+			return NO_EVENT;
+	}
+
 	// Tell whether a OAM DMA operation is active
 	bool DMAController::isOAMDMAActive() const {
 		return m_oamDmaMapping->active;
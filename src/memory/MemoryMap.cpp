@@ -8,76 +8,143 @@ namespace toygb {
 
 	// Initialize the memory map
 	MemoryMap::MemoryMap(){
-		m_tree = nullptr;
+		m_nodes = nullptr;
+		m_nodesize = 0;
+		for (int page = 0; page < 256; page++) {
+			m_pages[page] = nullptr;
+			m_subpages[page] = nullptr;
+			m_readPages[page] = nullptr;
+			m_writePages[page] = nullptr;
+		}
 	}
 
 	MemoryMap::~MemoryMap(){
-		if (m_tree != nullptr) delete[] m_tree;
-		m_tree = nullptr;
+		clearPages();
+		if (m_nodes != nullptr) delete[] m_nodes;
+		m_nodes = nullptr;
 	}
 
 	// Configure a memory mapping with its start and end absolute addresses (INCLUDED), and put it in the temporary array
 	void MemoryMap::add(uint16_t start, uint16_t end, MemoryMapping* mapping) {
 		MemoryMap::Node node(start, end, mapping);
 		m_array.push_back(node);
+		mapping->m_memoryMap = this;
 	}
 
-	// Build the final binary search tree with all mappings configured in the array
+	// Build the final page table with all mappings configured in the array
 	void MemoryMap::build() {
-		if (m_tree != nullptr) delete[] m_tree;
-
-		m_treesize = m_array.size();
-		m_tree = new MemoryMap::Node[m_treesize];
+		clearPages();
+		if (m_nodes != nullptr) delete[] m_nodes;
 
 		std::sort(m_array.begin(), m_array.end(), MemoryMap::NodeComparator());
-		buildSubtree(0, 0, m_array.size());
-	}
-
-	// Recursively build the binary search tree from the sorted temporary array
-	void MemoryMap::buildSubtree(int rootindex, int startindex, int endindex) {
-		int size = endindex - startindex;
-
-		if (size == 0) return;
-		if (size == 1){
-			m_tree[rootindex] = m_array[startindex];
-			return;
+		m_nodesize = m_array.size();
+		m_nodes = new MemoryMap::Node[m_nodesize];
+		for (int i = 0; i < m_nodesize; i++) {
+			m_nodes[i] = m_array[i];
+
+			// Mappings are sorted by start address, so an overlap can only be with the previous one
+			if (i > 0 && m_nodes[i].start <= m_nodes[i - 1].end) {
+				std::stringstream errstream;
+				errstream << "Overlapping memory mappings : " << oh16(m_nodes[i - 1].start) << "-" << oh16(m_nodes[i - 1].end) << " and " << oh16(m_nodes[i].start) << "-" << oh16(m_nodes[i].end);
+				throw EmulationError(errstream.str());
+			}
 		}
 
-		int depth = int(std::floor(std::log2(size)));
-		int base = (1 << depth) - 1;
-		int sidebase = (1 << (depth - 1)) - 1;
-		int lastrow = size - base;
+		for (int i = 0; i < m_nodesize; i++) {
+			MemoryMap::Node* node = &m_nodes[i];
+			for (int page = node->start >> 8; page <= node->end >> 8; page++) {
+				uint16_t pageStart = page << 8;
+				uint16_t pageEnd = pageStart | 0xFF;
+
+				if (node->start <= pageStart && pageEnd <= node->end && m_subpages[page] == nullptr) {
+					// The mapping covers the whole page, dispatch it directly
+					m_pages[page] = node;
+				} else {
+					// Only a part of the page is handled by this mapping, split it into a sub-table
+					if (m_subpages[page] == nullptr) {
+						m_subpages[page] = new MemoryMap::Subpage[256];
+						for (int offset = 0; offset < 256; offset++)
+							m_subpages[page][offset].node = nullptr;
+					}
+
+					int startOffset = max(node->start, pageStart) - pageStart;
+					int endOffset = min(node->end, pageEnd) - pageStart;
+					for (int offset = startOffset; offset <= endOffset; offset++)
+						m_subpages[page][offset].node = node;
+				}
+			}
+		}
 
-		int leftsize = sidebase + min(lastrow, sidebase + 1);
-		//int rightsize = sidebase + max(0, lastrow - (sidebase + 1));
+		for (int page = 0; page < 256; page++)
+			updatePage(page);
+	}
 
-		m_tree[rootindex] = m_array[startindex + leftsize];
-		buildSubtree(2*rootindex + 1, startindex, startindex + leftsize);
-		buildSubtree(2*rootindex + 2, startindex + leftsize + 1, endindex);
+	// Fetch the direct access pointers of the given mapping again for the given relative address range
+	void MemoryMap::updateDirectAccess(MemoryMapping* mapping, uint16_t start, uint16_t end) {
+		for (int i = 0; i < m_nodesize; i++) {
+			MemoryMap::Node* node = &m_nodes[i];
+			if (node->mapping == mapping) {
+				int startAddress = node->start + start;
+				int endAddress = min(int(node->end), node->start + end);
+				for (int page = startAddress >> 8; page <= endAddress >> 8; page++)
+					updatePage(page);
+			}
+		}
 	}
 
-	// Get the node to dispatch the given address to, or nullptr if none found
-	MemoryMap::Node* MemoryMap::getNode(uint16_t address) {
-		int index = 0;
-		MemoryMap::Node* found = nullptr;
-		while (found == nullptr && index < m_treesize){
-			MemoryMap::Node* node = &(m_tree[index]);
-			if (node->start <= address) {  // Node start <= searched address -> need to control the end address
-				if (address <= node->end)  // Node start <= searched address <= node end -> found
-					found = node;
-				else  // Node end < searched address -> search on the right (>) side
-					index = 2*index + 2;  // right
-			} else {  // Searched address < Node start -> search on the left (<) side
-				index = 2*index + 1;  // left
+	// Fetch the direct access pointers for the given page from the mappings that handle it
+	void MemoryMap::updatePage(int page) {
+		uint16_t pageStart = page << 8;
+		MemoryMap::Node* node = m_pages[page];
+		if (node != nullptr) {
+			m_readPages[page] = node->mapping->getReadPointer(pageStart - node->start);
+			m_writePages[page] = node->mapping->getWritePointer(pageStart - node->start);
+		} else {
+			m_readPages[page] = nullptr;
+			m_writePages[page] = nullptr;
+		}
+
+		// For split pages, do the same for each address
+		if (m_subpages[page] != nullptr) {
+			for (int offset = 0; offset < 256; offset++) {
+				MemoryMap::Subpage* entry = &m_subpages[page][offset];
+				if (entry->node != nullptr) {
+					entry->readPointer = entry->node->mapping->getReadPointer(pageStart + offset - entry->node->start);
+					entry->writePointer = entry->node->mapping->getWritePointer(pageStart + offset - entry->node->start);
+				} else {
+					entry->readPointer = nullptr;
+					entry->writePointer = nullptr;
+				}
 			}
 		}
+	}
+
+	// Clear the page table and free all sub-tables
+	void MemoryMap::clearPages() {
+		for (int page = 0; page < 256; page++) {
+			if (m_subpages[page] != nullptr) delete[] m_subpages[page];
+			m_subpages[page] = nullptr;
+			m_pages[page] = nullptr;
+			m_readPages[page] = nullptr;
+			m_writePages[page] = nullptr;
+		}
+	}
 
-		return found;
+	// Get the node to dispatch the given address to, or nullptr if none found
+	inline MemoryMap::Node* MemoryMap::getNode(uint16_t address) {
+		MemoryMap::Subpage* subpage = m_subpages[address >> 8];
+		if (subpage != nullptr)
+			return subpage[address & 0xFF].node;
+		return m_pages[address >> 8];
 	}
 
 
 	// Dispatch a memory read to the corresponding memory mapping
-	uint8_t MemoryMap::get(uint16_t address) {
+	uint8_t MemoryMap::dispatchGet(uint16_t address) {
+		MemoryMap::Subpage* subpage = m_subpages[address >> 8];
+		if (subpage != nullptr && subpage[address & 0xFF].readPointer != nullptr)
+			return *subpage[address & 0xFF].readPointer;
+
 		MemoryMap::Node* node = getNode(address);
 		if (node != nullptr){
 			return node->mapping->get(address - node->start);
@@ -90,7 +157,13 @@ namespace toygb {
 	}
 
 	// Dispatch a memory write to the corresponding memory mapping
-	void MemoryMap::set(uint16_t address, uint8_t value) {
+	void MemoryMap::dispatchSet(uint16_t address, uint8_t value) {
+		MemoryMap::Subpage* subpage = m_subpages[address >> 8];
+		if (subpage != nullptr && subpage[address & 0xFF].writePointer != nullptr) {
+			*subpage[address & 0xFF].writePointer = value;
+			return;
+		}
+
 		// In the real hardware, FF60 is a test IO register (only accessible when CPU test pins are not grounded)
 		// So for quick debugging, let's log anything that gets written there
 		if (address == 0xFF60) {
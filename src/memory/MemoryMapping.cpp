@@ -1,7 +1,12 @@
 #include "memory/MemoryMapping.hpp"
+#include "memory/MemoryMap.hpp"
 
 
 namespace toygb {
+	MemoryMapping::MemoryMapping() {
+		m_memoryMap = nullptr;
+	}
+
 	MemoryMapping::~MemoryMapping() {
 
 	}
@@ -15,4 +20,20 @@ namespace toygb {
 	void MemoryMapping::save(std::ostream& output) {
 
 	}
+
+	// By default, all accesses go through get()
+	uint8_t* MemoryMapping::getReadPointer(uint16_t address) {
+		return nullptr;
+	}
+
+	// By default, all accesses go through set()
+	uint8_t* MemoryMapping::getWritePointer(uint16_t address) {
+		return nullptr;
+	}
+
+	// Make the memory map fetch the direct access pointers again for the given relative address range
+	void MemoryMapping::updateDirectAccess(uint16_t start, uint16_t end) {
+		if (m_memoryMap != nullptr)
+			m_memoryMap->updateDirectAccess(this, start, end);
+	}
 }
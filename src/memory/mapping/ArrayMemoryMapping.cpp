@@ -16,4 +16,14 @@ namespace toygb {
 	void ArrayMemoryMapping::set(uint16_t address, uint8_t value) {
 		m_array[address] = value;
 	}
+
+	// Plain array, can always be read directly
+	uint8_t* ArrayMemoryMapping::getReadPointer(uint16_t address) {
+		return m_array + address;
+	}
+
+	// Plain array, can always be written directly
+	uint8_t* ArrayMemoryMapping::getWritePointer(uint16_t address) {
+		return m_array + address;
+	}
 }
@@ -40,4 +40,23 @@ namespace toygb {
 			}
 		}
 	}
+
+	// Get the location of the given relative address in the array, for direct accesses
+	// The selected bank must be updated with updateDirectAccess() when it changes
+	uint8_t* FixBankedMemoryMapping::getReadPointer(uint16_t address) {
+		if (!accessible)
+			return nullptr;
+
+		if (address < m_bankSize || *m_bankSelect <= 1)  // First part : first bank fixed area
+			return m_array + address;
+		else if (*m_bankSelect > m_numBanks)  // Out of bounds, let get() and set() report the error
+			return nullptr;
+		else  // Second part : switchable area
+			return m_array + address - m_bankSize + (*m_bankSelect) * m_bankSize;
+	}
+
+	// Same as for reads
+	uint8_t* FixBankedMemoryMapping::getWritePointer(uint16_t address) {
+		return getReadPointer(address);
+	}
 }
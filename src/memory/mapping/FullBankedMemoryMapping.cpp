@@ -32,4 +32,21 @@ namespace toygb {
 			m_array[address + (*m_bankSelect)*m_bankSize] = value;
 		}
 	}
+
+	// Get the location of the given relative address in the array, for direct accesses
+	// The selected bank must be updated with updateDirectAccess() when it changes
+	uint8_t* FullBankedMemoryMapping::getReadPointer(uint16_t address) {
+		if (!accessible || *m_bankSelect >= m_numBanks)  // Out of bounds, let get() and set() deal with it
+			return nullptr;
+
+		int offset = address + (*m_bankSelect)*m_bankSize;
+		if (offset >= m_numBanks*m_bankSize)
+			return nullptr;
+		return m_array + offset;
+	}
+
+	// Same as for reads
+	uint8_t* FullBankedMemoryMapping::getWritePointer(uint16_t address) {
+		return getReadPointer(address);
+	}
 }
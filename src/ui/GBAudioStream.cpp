@@ -15,6 +15,8 @@ namespace toygb {
 		initialize(2, OUTPUT_SAMPLE_FREQUENCY);
 	}
 
+	// Called by SFML from its own audio thread
+	// If the emulation is late, getSamples() fills the end of the buffer by itself, and the stream must keep playing anyway
 	bool GBAudioStream::onGetData(sf::SoundStream::Chunk& data) {
 		m_controller->getSamples(m_sampleBuffer);
 
@@ -1,12 +1,15 @@
 #include "ui/Interface.hpp"
 #include <iostream>
+#include <algorithm>
 
-#define PIXEL_SIZE 4
-#define WINDOW_WIDTH LCD_WIDTH*PIXEL_SIZE
-#define WINDOW_HEIGHT LCD_HEIGHT*PIXEL_SIZE
+#define DEFAULT_SCALE 4
+
+// Key that draws the next frame when frame skipping is enabled
+#define FRAME_REQUEST_KEY sf::Keyboard::F
 
 namespace toygb {
-	Interface::Interface() {
+	Interface::Interface(GameboyConfig& config) {
+		m_smoothScaling = config.smoothScaling;
 		m_lcd = nullptr;
 		m_audio = nullptr;
 		m_joypad = nullptr;
@@ -19,27 +22,38 @@ namespace toygb {
 		m_audio = audio;
 		m_joypad = joypad;
 
-		sf::RenderWindow window(sf::VideoMode(WINDOW_WIDTH, WINDOW_HEIGHT), "ToyGB");
+		sf::RenderWindow window(sf::VideoMode(LCD_WIDTH*DEFAULT_SCALE, LCD_HEIGHT*DEFAULT_SCALE), "ToyGB");
+
+		// The texture holds the native LCD image, the scaling is left to the GPU
 		sf::Texture display;
-		if (!display.create(WINDOW_WIDTH, WINDOW_HEIGHT))
+		if (!display.create(LCD_WIDTH, LCD_HEIGHT))
 			window.close();
+		display.setSmooth(m_smoothScaling);
 
-		sf::Uint8* pixels = new sf::Uint8[WINDOW_WIDTH * WINDOW_HEIGHT * 4];
 		sf::Sprite screen;
 		screen.setTexture(display);
-		screen.setPosition(sf::Vector2f(0.0f, 0.0f));
+		updateLayout(window, screen);
 
 		setupAudio();
 
 		window.setFramerateLimit(60);
 		while (window.isOpen()) {
+			// Stop requested by the emulator
+			if (m_stopping) {
+				window.close();
+				m_audioStream.stop();
+				break;
+			}
+
 			sf::Event event;
 
 			updateJoypad();
-			updateGraphics(pixels);
 
-			display.update(pixels);
-			screen.setTexture(display);
+			// Only upload new frames, each of them exactly once, they are already in the texture format
+			if (m_lcd->hasNewFrame()) {
+				display.update(m_lcd->pixels());
+				screen.setTexture(display);
+			}
 			window.clear();
 			window.draw(screen);
 			window.display();
@@ -50,6 +64,11 @@ namespace toygb {
 					m_audioStream.stop();
 					m_stopping = true;
 					break;
+				} else if (event.type == sf::Event::Resized) {
+					updateLayout(window, screen);
+				} else if (event.type == sf::Event::KeyPressed && event.key.code == FRAME_REQUEST_KEY) {
+					// Show the current frame even if it would be skipped (see LCDController::setFrameSkip)
+					m_lcd->requestFrame();
 				}
 			}
 		}
@@ -66,26 +85,15 @@ namespace toygb {
 		m_joypad->setButton(JoypadButton::Select, sf::Keyboard::isKeyPressed(sf::Keyboard::N));
 	}
 
-	void Interface::updateGraphics(sf::Uint8* pixels) {
-		uint16_t* gbValues = m_lcd->pixels();
-		for (int x = 0; x < LCD_WIDTH; x++) {
-			for (int y = 0; y < LCD_HEIGHT; y++) {
-				uint16_t gbValue = gbValues[y*LCD_WIDTH + x];
-				uint8_t red = ((gbValue & 0x1F) << 3) + 0b101;
-				uint8_t green = (((gbValue >> 5) & 0x1F) << 3) + 0b101;
-				uint8_t blue = (((gbValue >> 10) & 0x1F) << 3) + 0b101;
-				uint8_t alpha = 255;
-				for (int xpix = 0; xpix < PIXEL_SIZE; xpix++) {
-					for (int ypix = 0; ypix < PIXEL_SIZE; ypix++) {
-						int index = 4*((y*PIXEL_SIZE + ypix)*WINDOW_WIDTH + (x*PIXEL_SIZE + xpix));
-						pixels[index] = red;
-						pixels[index + 1] = green;
-						pixels[index + 2] = blue;
-						pixels[index + 3] = alpha;
-					}
-				}
-			}
-		}
+	// Fit the screen in the window at the largest integer scale that fits, centered
+	// Integer factors keep all emulated pixels the same size when the filtering is nearest-neighbour
+	void Interface::updateLayout(sf::RenderWindow& window, sf::Sprite& screen) {
+		sf::Vector2u size = window.getSize();
+		window.setView(sf::View(sf::FloatRect(0.0f, 0.0f, size.x, size.y)));
+
+		unsigned int scale = std::max(1U, std::min(size.x / LCD_WIDTH, size.y / LCD_HEIGHT));
+		screen.setScale(sf::Vector2f(scale, scale));
+		screen.setPosition(sf::Vector2f(((int)size.x - (int)(LCD_WIDTH*scale)) / 2, ((int)size.y - (int)(LCD_HEIGHT*scale)) / 2));
 	}
 
 	void Interface::setupAudio() {
@@ -96,4 +104,9 @@ namespace toygb {
 	bool Interface::isStopping() {
 		return m_stopping;
 	}
+
+	// Request the interface to close, it will be closed on its next frame
+	void Interface::stop() {
+		m_stopping = true;
+	}
 }